@@ -0,0 +1,138 @@
+#include "bundle.h"
+#include "error_handler.h"
+
+#include <stdio.h>   /* For sscanf */
+#include <stdlib.h>  /* For malloc, free */
+#include <string.h>  /* For memchr, memcpy, strcmp */
+
+/* Longest header or index line: a size, a space and a base name */
+#define BUNDLE_LINE_SIZE (MAX_INPUT_NAME_LENGTH + 32)
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Checks that a member name is a plain base name, safe to use as an output path
+ * @param name The member name
+ * @return TRUE if the name has no directory separator and no "..", FALSE otherwise
+ */
+static int is_safe_member_name(const char* name) {
+    return strchr(name, '/') == NULL && strchr(name, '\\') == NULL && strstr(name, "..") == NULL;
+}
+
+/**
+ * @brief Copies the next header or index line of a bundle, without its newline
+ * @param contents The bundle contents; the read position is advanced past the line
+ * @param line The buffer that receives the line (BUNDLE_LINE_SIZE bytes)
+ * @return TRUE on success, FALSE if there is no complete line or it is too long
+ */
+static int read_index_line(SourceBuffer* contents, char* line) {
+    const char* start = contents->data + contents->position;
+    const char* newline;
+    unsigned long length;
+
+    if (contents->position >= contents->size) {
+        return FALSE;
+    }
+    newline = (const char*)memchr(start, '\n', contents->size - contents->position);
+    if (newline == NULL) {
+        return FALSE;
+    }
+    length = (unsigned long)(newline - start);
+    if (length >= BUNDLE_LINE_SIZE) {
+        return FALSE;
+    }
+
+    memcpy(line, start, length);
+    line[length] = '\0';
+    if (length > 0 && line[length - 1] == '\r') {
+        line[length - 1] = '\0';
+    }
+    contents->position += length + 1;
+    return TRUE;
+}
+
+/**
+ * @brief Parses the header and the index of a bundle
+ * @param bundle The bundle whose contents were read
+ * @return TRUE if the header and every index entry are valid, FALSE otherwise
+ */
+static int parse_index(Bundle* bundle) {
+    char line[BUNDLE_LINE_SIZE];
+    char magic[8];
+    char extra[2];
+    int version;
+    int count;
+    unsigned long offset;
+    int i;
+
+    if (!read_index_line(&bundle->contents, line) ||
+        sscanf(line, "%7s %d %d %1s", magic, &version, &count, extra) != 3 ||
+        strcmp(magic, BUNDLE_MAGIC) != 0 || version != BUNDLE_VERSION || count < 0) {
+        return FALSE;
+    }
+    /* Every index line takes at least 4 bytes, which bounds the count before allocating */
+    if ((unsigned long)count > (bundle->contents.size - bundle->contents.position) / 4) {
+        return FALSE;
+    }
+
+    bundle->members = (BundleMember*)malloc((count > 0 ? count : 1) * sizeof(BundleMember));
+    if (bundle->members == NULL) {
+        return FALSE;
+    }
+
+    for (i = 0; i < count; i++) {
+        BundleMember* member = &bundle->members[i];
+        int name_start = 0;
+        if (!read_index_line(&bundle->contents, line) ||
+            sscanf(line, "%lu %n", &member->size, &name_start) != 1 ||
+            name_start == 0 || line[name_start] == '\0' ||
+            strlen(line + name_start) > MAX_INPUT_NAME_LENGTH ||
+            !is_safe_member_name(line + name_start)) {
+            return FALSE;
+        }
+        strcpy(member->name, line + name_start);
+        bundle->member_count++;
+    }
+
+    /* The members follow the index back to back and must fit in the file */
+    offset = bundle->contents.position;
+    for (i = 0; i < count; i++) {
+        if (bundle->members[i].size > bundle->contents.size - offset) {
+            return FALSE;
+        }
+        bundle->members[i].offset = offset;
+        offset += bundle->members[i].size;
+    }
+    return TRUE;
+}
+
+/* --- Public Functions Implementation --- */
+
+int load_bundle(Bundle* bundle, const char* bundle_path) {
+    bundle->members = NULL;
+    bundle->member_count = 0;
+
+    if (!read_source_file(&bundle->contents, bundle_path)) {
+        report_error(bundle_path, 0, ERROR_FILE_OPEN_FAILED);
+        return FALSE;
+    }
+    if (!parse_index(bundle)) {
+        report_error(bundle_path, 0, ERROR_INVALID_BUNDLE);
+        free_bundle(bundle);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void get_bundle_member(const Bundle* bundle, int index, SourceBuffer* source) {
+    source->data = bundle->contents.data + bundle->members[index].offset;
+    source->size = bundle->members[index].size;
+    source->position = 0;
+}
+
+void free_bundle(Bundle* bundle) {
+    free_source(&bundle->contents);
+    free(bundle->members);
+    bundle->members = NULL;
+    bundle->member_count = 0;
+}
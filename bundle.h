@@ -0,0 +1,76 @@
+#ifndef ASSEMBLER_BUNDLE_H
+#define ASSEMBLER_BUNDLE_H
+
+/* Include necessary project definitions */
+#include "definitions.h"   /* Includes TRUE/FALSE and BUNDLE_EXTENSION */
+#include "source_buffer.h" /* Includes SourceBuffer */
+#include "file_list.h"     /* Includes MAX_INPUT_NAME_LENGTH */
+
+/**
+ * @brief This header file declares the source bundle (.asb) input format.
+ * A bundle packs many small source files into one file, so a generator can
+ * write (and the assembler read) a single file instead of thousands. It is
+ * read into memory with one read, and each member is then pre-assembled
+ * straight from that memory as if it were a separate .as file.
+ *
+ * Format: a header line, one index line per member, then the contents of
+ * the members back to back, in index order:
+ *     ASB 1 <member_count>
+ *     <size_in_bytes> <member_base_name>
+ *     ...
+ *     <contents of member 1><contents of member 2>...
+ * The output of each member is written to "<member_base_name>.am", in the
+ * working directory; a name that contains '/', '\' or ".." makes the bundle
+ * invalid, so a bundle cannot write outside it.
+ */
+
+#define BUNDLE_MAGIC "ASB"
+#define BUNDLE_VERSION 1
+
+/* --- Bundle Definitions --- */
+
+/**
+ * @brief One source file inside a bundle.
+ */
+typedef struct {
+    char name[MAX_INPUT_NAME_LENGTH + 1];   /* Base name of the member */
+    unsigned long offset;                   /* Offset of its contents in the bundle */
+    unsigned long size;                     /* Size of its contents in bytes */
+} BundleMember;
+
+/**
+ * @brief A bundle loaded into memory.
+ */
+typedef struct {
+    SourceBuffer contents;  /* The whole bundle file */
+    BundleMember* members;  /* The index */
+    int member_count;       /* Number of members */
+} Bundle;
+
+/* --- Bundle Functions --- */
+
+/**
+ * @brief Reads a bundle and validates its index.
+ * Errors (missing file, malformed header or index) are reported through the error handler.
+ * @param bundle The bundle to fill.
+ * @param bundle_path The path of the bundle file.
+ * @return TRUE if the bundle was loaded, FALSE otherwise.
+ */
+int load_bundle(Bundle* bundle, const char* bundle_path);
+
+/**
+ * @brief Makes a source buffer that reads one member of a loaded bundle.
+ * The source buffer shares the bundle's memory and must not be freed.
+ * @param bundle The loaded bundle.
+ * @param index The index of the member.
+ * @param source The source buffer to set up.
+ */
+void get_bundle_member(const Bundle* bundle, int index, SourceBuffer* source);
+
+/**
+ * @brief Releases a loaded bundle.
+ * @param bundle The bundle to release.
+ */
+void free_bundle(Bundle* bundle);
+
+#endif /* ASSEMBLER_BUNDLE_H */
@@ -24,6 +24,11 @@
  * The registers are named r0 to r7 .*/
 #define NUM_REGISTERS 8
 
+/**
+ * @brief Version of the assembler, recorded in the output manifest.
+ */
+#define ASSEMBLER_VERSION "1.0.0"
+
 /* --- Boolean Constants for C90 Compatibility --- */
 #define TRUE 1
 #define FALSE 0
@@ -33,6 +38,8 @@
 #define AM_EXTENSION ".am"
 #define AS_EXTENSION_LENGTH 3
 #define AM_EXTENSION_LENGTH 3
+#define BUNDLE_EXTENSION ".asb"
+#define BUNDLE_EXTENSION_LENGTH 4
 
 /* --- Constants for "Unique Base 4" Encoding --- */
 /**
@@ -105,6 +112,37 @@ typedef enum {
     ADDRESSING_REGISTER_DIRECT = 3  /* Register direct addressing: rX  */
 } AddressingMethod;
 
+/**
+ * @brief The number of opcodes and addressing methods, used to size the constant tables.
+ */
+#define NUM_OPCODES 16
+#define NUM_ADDRESSING_METHODS 4
+
+/* --- Addressing Method Sets --- */
+/**
+ * @brief Bit masks describing a set of addressing methods (bit N set = method N allowed).
+ * These are used to spell out the instruction specification in the constant tables.
+ */
+#define ADDRESSING_SET_NONE 0x0                /* No operand in this position */
+#define ADDRESSING_SET_ALL 0xF                 /* Methods 0, 1, 2, 3 */
+#define ADDRESSING_SET_NO_IMMEDIATE 0xE        /* Methods 1, 2, 3 */
+#define ADDRESSING_SET_DIRECT_OR_MATRIX 0x6    /* Methods 1, 2 */
+
+/**
+ * @brief Builds the 4x4 legality bitset of an instruction from its source and destination sets.
+ * Bit (source * 4 + destination) is set when that pair of addressing methods is legal.
+ * A missing operand position is a "don't care": a source set of ADDRESSING_SET_NONE
+ * accepts any source value, so one-operand instructions are checked on the destination only.
+ * The operand count table decides whether an operand may be present at all.
+ */
+#define ADDRESSING_DST_ROW(dst_set) ((dst_set) == ADDRESSING_SET_NONE ? ADDRESSING_SET_ALL : (dst_set))
+#define ADDRESSING_SRC_SET(src_set) ((src_set) == ADDRESSING_SET_NONE ? ADDRESSING_SET_ALL : (src_set))
+#define ADDRESSING_PAIR_BITS(src_set, dst_set) \
+    ((((ADDRESSING_SRC_SET(src_set) >> 0) & 1) ? (ADDRESSING_DST_ROW(dst_set) << 0) : 0) | \
+     (((ADDRESSING_SRC_SET(src_set) >> 1) & 1) ? (ADDRESSING_DST_ROW(dst_set) << 4) : 0) | \
+     (((ADDRESSING_SRC_SET(src_set) >> 2) & 1) ? (ADDRESSING_DST_ROW(dst_set) << 8) : 0) | \
+     (((ADDRESSING_SRC_SET(src_set) >> 3) & 1) ? (ADDRESSING_DST_ROW(dst_set) << 12) : 0))
+
 /* --- Placeholder for future Data Structures --- */
 
 /**
@@ -16,12 +16,20 @@ static const char* error_messages[] = {
     "Failed to open source or output file.", /* ERROR_FILE_OPEN_FAILED */
     "Source line exceeds maximum allowed length (MAX_LINE_LENGTH).", /* ERROR_LINE_TOO_LONG */
     "Input file is empty or contains only comment lines.", /* ERROR_EMPTY_OR_COMMENT_FILE */
+    "Source bundle has a malformed header or index.", /* ERROR_INVALID_BUNDLE */
     "Macro name is a reserved keyword (opcode, directive, or register).", /* ERROR_MACRO_NAME_RESERVED_KEYWORD */
     "Macro name does not follow legal label format (e.g., starts with a digit, too long).", /* ERROR_MACRO_NAME_INVALID_FORMAT */
     "Syntax error in 'mcro' definition line (e.g., extra characters).", /* ERROR_MACRO_DEFINITION_SYNTAX */
     "Nested macro definitions are not allowed.", /* ERROR_NESTED_MACRO_DEFINITION */
+    "Macro calls itself, directly or through other macros.", /* ERROR_RECURSIVE_MACRO_CALL */
     "Unexpected 'mcroend' encountered without a preceding 'mcro' definition.", /* ERROR_UNEXPECTED_MACRO_END */
     "End of file reached before 'mcroend' was found for an open macro definition.", /* ERROR_UNCLOSED_MACRO_DEFINITION */
+    "Precompiled macro library is malformed or has an unsupported version.", /* ERROR_INVALID_MACRO_LIBRARY */
+    "Malformed '.rept' block (count must be 1-256, no label, no nesting, not inside a macro).", /* ERROR_REPEAT_BLOCK_SYNTAX */
+    "End of file reached before '.endr' was found for an open '.rept' block.", /* ERROR_UNCLOSED_REPEAT_BLOCK */
+    "Malformed '.incbin' (expected .incbin \"file\", width with width 1 or 2; not inside a macro or '.rept' block).", /* ERROR_INCBIN_SYNTAX */
+    "Binary file of '.incbin' cannot be read, is empty, exceeds memory, or is not a multiple of the width.", /* ERROR_INCBIN_FILE */
+    "Value in '.incbin' file does not fit in a 10-bit word (-512 to 511).", /* ERROR_INCBIN_VALUE_OUT_OF_RANGE */
     "Label is defined more than once in the file.", /* ERROR_LABEL_REDEFINITION */
     "Label name is a reserved keyword (opcode, directive, or register).", /* ERROR_LABEL_RESERVED_KEYWORD */
     "Label name does not meet the specified format (e.g., starts with a digit, too long).", /* ERROR_LABEL_INVALID_FORMAT */
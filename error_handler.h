@@ -29,14 +29,22 @@ typedef enum {
     ERROR_FILE_OPEN_FAILED,                 /* Failed to open the source or output file */
     ERROR_LINE_TOO_LONG,                    /* Source line exceeds the maximum allowed length (MAX_LINE_LENGTH) */
     ERROR_EMPTY_OR_COMMENT_FILE,            /* Input file is empty or contains only comments */
+    ERROR_INVALID_BUNDLE,                   /* Source bundle (.asb) has a malformed header or index */
 
     /* Pre-assembler (Macro) related errors */
     ERROR_MACRO_NAME_RESERVED_KEYWORD,      /* Macro name is a reserved keyword (opcode, directive, or register) */
     ERROR_MACRO_NAME_INVALID_FORMAT,        /* Macro name does not follow legal label format (e.g., starts with a digit, too long) */
     ERROR_MACRO_DEFINITION_SYNTAX,          /* Syntax error in a 'mcro' definition line (e.g., extra characters) */
     ERROR_NESTED_MACRO_DEFINITION,          /* Nested macro definitions are not allowed */
+    ERROR_RECURSIVE_MACRO_CALL,             /* A macro calls itself, directly or through other macros */
     ERROR_UNEXPECTED_MACRO_END,             /* 'mcroend' encountered without a preceding 'mcro' */
     ERROR_UNCLOSED_MACRO_DEFINITION,        /* End of file reached before 'mcroend' was found for an open macro definition */
+    ERROR_INVALID_MACRO_LIBRARY,            /* Precompiled macro library (.mlib) is malformed or has an unsupported version */
+    ERROR_REPEAT_BLOCK_SYNTAX,              /* Malformed '.rept'/'.endr' (bad count, label, nesting, or inside a macro) */
+    ERROR_UNCLOSED_REPEAT_BLOCK,            /* End of file reached before '.endr' was found for an open '.rept' block */
+    ERROR_INCBIN_SYNTAX,                    /* Malformed '.incbin' (bad path or width, or inside a macro or repeat block) */
+    ERROR_INCBIN_FILE,                      /* Binary file of '.incbin' cannot be read, is empty, too large or truncated */
+    ERROR_INCBIN_VALUE_OUT_OF_RANGE,        /* Value in a '.incbin' file does not fit in a 10-bit word */
 
     /* Label/Symbol related errors */
     ERROR_LABEL_REDEFINITION,               /* Label is defined more than once in the file */
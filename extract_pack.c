@@ -0,0 +1,250 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L  /* For mkdir under -std=c99 */
+#define EXTRACT_DIRECTORIES      /* Missing parent directories are created */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef EXTRACT_DIRECTORIES
+#include <sys/stat.h>  /* For mkdir */
+#endif
+
+#include "packfile.h"
+
+/**
+ * @brief A tiny extractor for the packfiles written by "assembler --pack=<file>".
+ * Usage: ./extract_pack [--list] <packfile> [member...]
+ * Without member names every member is extracted to its original output path;
+ * --list prints the size, hash and name of the members instead. The contents of
+ * every member are checked against the hash stored in the index. Members are
+ * only extracted below the current directory: a leading '/' and everything up
+ * to a ".." component are removed from the name, and missing directories are created.
+ */
+
+#define LIST_OPTION "--list"
+#define PATH_BUFFER_SIZE 1024
+
+/**
+ * @brief Reads a little-endian 32-bit number
+ * @param bytes The first byte of the number
+ * @return The number
+ */
+static unsigned long read_word(const unsigned char* bytes) {
+    return (unsigned long)bytes[0] | ((unsigned long)bytes[1] << 8) |
+           ((unsigned long)bytes[2] << 16) | ((unsigned long)bytes[3] << 24);
+}
+
+/**
+ * @brief Computes the FNV-1a hash of a member, as the assembler does
+ * @param data The member contents
+ * @param size The number of bytes
+ * @return The 32-bit hash value
+ */
+static unsigned long hash_contents(const unsigned char* data, unsigned long size) {
+    unsigned long hash = 2166136261UL;
+    unsigned long i;
+    for (i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Reads a whole file into memory
+ * @param path The path of the file
+ * @param size Receives the size of the file
+ * @return The contents, or NULL if the file could not be read
+ */
+static unsigned char* read_whole_file(const char* path, unsigned long* size) {
+    FILE* file = fopen(path, "rb");
+    unsigned char* data;
+    long length;
+
+    if (file == NULL) {
+        return NULL;
+    }
+    if (fseek(file, 0L, SEEK_END) != 0 || (length = ftell(file)) < 0 || fseek(file, 0L, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    data = (unsigned char*)malloc(length > 0 ? (unsigned long)length : 1);
+    if (data != NULL && fread(data, 1, (unsigned long)length, file) != (unsigned long)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = (unsigned long)length;
+    return data;
+}
+
+/**
+ * @brief Maps a member name to the path it is extracted to, below the current directory
+ * As tar does, leading '/' characters and everything up to the last ".." component
+ * are removed, so "/tmp/pk/a.am" is extracted to "tmp/pk/a.am" and "../up.am" to "up.am".
+ * @param name The member name
+ * @return The path within name, or NULL if nothing is left of it
+ */
+static const char* member_output_path(const char* name) {
+    const char* path = name;
+    const char* component = name;
+
+    while (component != NULL) {
+        if (component[0] == '.' && component[1] == '.' &&
+            (component[2] == '\0' || component[2] == '/' || component[2] == '\\')) {
+            path = component + 2;
+        }
+        component = strpbrk(component, "/\\");
+        if (component != NULL) {
+            component++;
+        }
+    }
+    while (*path == '/' || *path == '\\') {
+        path++;
+    }
+    return (*path != '\0') ? path : NULL;
+}
+
+/**
+ * @brief Creates the missing parent directories of a path
+ * Errors are not reported here; opening the file then fails and is reported.
+ * @param path The path of a file, relative to the current directory
+ */
+static void create_parent_directories(const char* path) {
+#ifdef EXTRACT_DIRECTORIES
+    char directory[PATH_BUFFER_SIZE];
+    const char* separator = strchr(path, '/');
+
+    while (separator != NULL && (unsigned long)(separator - path) < sizeof(directory)) {
+        memcpy(directory, path, separator - path);
+        directory[separator - path] = '\0';
+        mkdir(directory, 0777);  /* Fails harmlessly if it already exists */
+        separator = strchr(separator + 1, '/');
+    }
+#else
+    (void)path;
+#endif
+}
+
+/**
+ * @brief Checks whether a member was requested on the command line
+ * @param name The member name
+ * @param names The requested names
+ * @param count The number of requested names (0 = all members)
+ * @return 1 if the member is requested, 0 otherwise
+ */
+static int is_requested(const char* name, char* names[], int count) {
+    int i;
+    if (count == 0) {
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    const unsigned char* trailer;
+    const unsigned char* record;
+    unsigned char* data;
+    unsigned long size = 0;
+    unsigned long member_count;
+    unsigned long index_offset;
+    unsigned long i;
+    int list_only = 0;
+    int first_argument = 1;
+    int failures = 0;
+
+    if (argc > 1 && strcmp(argv[1], LIST_OPTION) == 0) {
+        list_only = 1;
+        first_argument = 2;
+    }
+    if (argc <= first_argument) {
+        printf("Usage: %s [--list] <packfile> [member...]\n", argv[0]);
+        return 1;
+    }
+
+    data = read_whole_file(argv[first_argument], &size);
+    if (data == NULL) {
+        printf("❌ Failed to read packfile: %s\n", argv[first_argument]);
+        return 1;
+    }
+
+    /* Validate the trailer and the bounds of the index */
+    trailer = (size >= PACK_TRAILER_WORDS * PACK_WORD_SIZE) ? data + size - PACK_TRAILER_WORDS * PACK_WORD_SIZE : NULL;
+    if (trailer == NULL || memcmp(trailer, PACK_MAGIC, PACK_WORD_SIZE) != 0 ||
+        read_word(trailer + PACK_WORD_SIZE) != PACK_FORMAT_VERSION) {
+        printf("❌ Not a packfile or unsupported version: %s\n", argv[first_argument]);
+        free(data);
+        return 1;
+    }
+    member_count = read_word(trailer + 2 * PACK_WORD_SIZE);
+    index_offset = read_word(trailer + 3 * PACK_WORD_SIZE);
+    if (index_offset > (unsigned long)(trailer - data) ||
+        member_count > ((unsigned long)(trailer - data) - index_offset) / (PACK_RECORD_WORDS * PACK_WORD_SIZE)) {
+        printf("❌ Packfile index is malformed: %s\n", argv[first_argument]);
+        free(data);
+        return 1;
+    }
+
+    for (i = 0; i < member_count; i++) {
+        unsigned long name_offset, name_length, data_offset, data_size, hash;
+        const char* name;
+        const char* path;
+        FILE* output;
+
+        record = data + index_offset + i * PACK_RECORD_WORDS * PACK_WORD_SIZE;
+        name_offset = read_word(record);
+        name_length = read_word(record + PACK_WORD_SIZE);
+        data_offset = read_word(record + 2 * PACK_WORD_SIZE);
+        data_size = read_word(record + 3 * PACK_WORD_SIZE);
+        hash = read_word(record + 4 * PACK_WORD_SIZE);
+        if (name_offset >= size || name_length >= size - name_offset || data[name_offset + name_length] != '\0' ||
+            data_offset > index_offset || data_size > index_offset - data_offset) {
+            printf("❌ Packfile member %lu is malformed\n", i);
+            failures++;
+            continue;
+        }
+        name = (const char*)data + name_offset;
+
+        if (!is_requested(name, argv + first_argument + 1, argc - first_argument - 1)) {
+            continue;
+        }
+        if (hash_contents(data + data_offset, data_size) != hash) {
+            printf("❌ Hash mismatch: %s\n", name);
+            failures++;
+            continue;
+        }
+        if (list_only) {
+            printf("%10lu %08lx %s\n", data_size, hash, name);
+            continue;
+        }
+        path = member_output_path(name);
+        if (path == NULL) {
+            printf("❌ Member name is not a file path: %s\n", name);
+            failures++;
+            continue;
+        }
+        if (path != name) {
+            printf("Extracting %s as %s\n", name, path);
+        }
+
+        create_parent_directories(path);
+        output = fopen(path, "wb");
+        if (output == NULL || fwrite(data + data_offset, 1, data_size, output) != data_size) {
+            printf("❌ Failed to write: %s\n", path);
+            failures++;
+        }
+        if (output != NULL) {
+            fclose(output);
+        }
+    }
+
+    free(data);
+    return failures == 0 ? 0 : 1;
+}
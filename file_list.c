@@ -0,0 +1,303 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L  /* For stat, lstat and opendir under -std=c99 */
+#define FILE_LIST_DIRECTORIES    /* Directory arguments are supported */
+#endif
+
+#include "file_list.h"
+
+#include <stdio.h>   /* For printf, fopen, fgets */
+#include <stdlib.h>  /* For malloc, realloc, free, qsort */
+#include <string.h>  /* For strlen, strcmp, memcpy */
+
+#ifdef FILE_LIST_DIRECTORIES
+#include <sys/stat.h>  /* For stat, lstat */
+#include <dirent.h>    /* For opendir, readdir */
+#endif
+
+/* Size of the buffers used for response file lines and directory paths */
+#define PATH_BUFFER_SIZE 1024
+
+/**
+ * @brief One input while the list is being sorted
+ */
+typedef struct {
+    char* name;
+    long size;
+} SortEntry;
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Checks whether a name ends with the .as extension
+ * @param name The name to check
+ * @param length The length of the name
+ * @return TRUE if the name ends with .as, FALSE otherwise
+ */
+static int has_source_extension(const char* name, int length) {
+    return length > AS_EXTENSION_LENGTH &&
+           strcmp(name + length - AS_EXTENSION_LENGTH, AS_EXTENSION) == 0;
+}
+
+/**
+ * @brief Finds the size of the file behind an input
+ * @param name The base name of an .as file, or the path of a bundle
+ * @return The size in bytes, or -1 if the file does not exist
+ */
+static long input_file_size(const char* name) {
+    char path[MAX_INPUT_NAME_LENGTH + AS_EXTENSION_LENGTH + 1];
+#ifdef FILE_LIST_DIRECTORIES
+    struct stat status;
+    sprintf(path, "%s%s", name, is_bundle_name(name) ? "" : AS_EXTENSION);
+    return (stat(path, &status) == 0) ? (long)status.st_size : -1L;
+#else
+    FILE* file;
+    long size = -1L;
+    sprintf(path, "%s%s", name, is_bundle_name(name) ? "" : AS_EXTENSION);
+    file = fopen(path, "r");
+    if (file != NULL) {
+        if (fseek(file, 0L, SEEK_END) == 0) {
+            size = ftell(file);
+        }
+        fclose(file);
+    }
+    return size;
+#endif
+}
+
+/**
+ * @brief Appends one input to the list, removing an .as extension from its name
+ * @param list The file list
+ * @param name The name of the input
+ * @param size The size of the input file in bytes, or -1 to look it up
+ * @return TRUE on success, FALSE if the name is too long or memory ran out
+ */
+static int add_name(FileList* list, const char* name, long size) {
+    int length = (int)strlen(name);
+    char* copy;
+
+    if (has_source_extension(name, length)) {
+        length -= AS_EXTENSION_LENGTH;
+    }
+    if (length > MAX_INPUT_NAME_LENGTH) {
+        printf("❌ Input file name is too long: %s\n", name);
+        return FALSE;
+    }
+
+    if (list->count >= list->capacity) {
+        int new_capacity = (list->capacity == 0) ? 16 : list->capacity * 2;
+        char** new_names = (char**)realloc(list->names, new_capacity * sizeof(char*));
+        long* new_sizes;
+        if (new_names == NULL) {
+            return FALSE;
+        }
+        list->names = new_names;
+        new_sizes = (long*)realloc(list->sizes, new_capacity * sizeof(long));
+        if (new_sizes == NULL) {
+            return FALSE;
+        }
+        list->sizes = new_sizes;
+        list->capacity = new_capacity;
+    }
+
+    copy = (char*)malloc(length + 1);
+    if (copy == NULL) {
+        return FALSE;
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+
+    list->names[list->count] = copy;
+    list->sizes[list->count] = (size >= 0) ? size : input_file_size(copy);
+    list->count++;
+    return TRUE;
+}
+
+static int add_argument(FileList* list, const char* argument, int depth);
+
+/**
+ * @brief Adds every input named in a response file, one per line
+ * Blank lines are skipped; leading and trailing whitespace is removed.
+ * @param list The file list
+ * @param path The path of the response file
+ * @param depth The response file nesting depth
+ * @return TRUE on success, FALSE otherwise
+ */
+static int add_response_file(FileList* list, const char* path, int depth) {
+    char line[PATH_BUFFER_SIZE];
+    FILE* file;
+    int success = TRUE;
+
+    if (depth > MAX_RESPONSE_FILE_DEPTH) {
+        printf("❌ Response files are nested too deeply: %s\n", path);
+        return FALSE;
+    }
+
+    file = fopen(path, "r");
+    if (file == NULL) {
+        printf("❌ Failed to open response file: %s\n", path);
+        return FALSE;
+    }
+
+    while (success && fgets(line, sizeof(line), file) != NULL) {
+        char* start = line;
+        char* end = line + strlen(line);
+        while (*start == ' ' || *start == '\t') {
+            start++;
+        }
+        while (end > start && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+            end--;
+        }
+        *end = '\0';
+        if (*start != '\0') {
+            success = add_argument(list, start, depth + 1);
+        }
+    }
+
+    fclose(file);
+    return success;
+}
+
+#ifdef FILE_LIST_DIRECTORIES
+
+/**
+ * @brief Checks whether a path names a directory
+ * @param path The path to check
+ * @return TRUE if the path is a directory, FALSE otherwise
+ */
+static int is_directory(const char* path) {
+    struct stat status;
+    return stat(path, &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+/**
+ * @brief Adds every .as and .asb file below a directory, recursively
+ * Symbolic links to directories are not followed.
+ * @param list The file list
+ * @param path The path of the directory
+ * @return TRUE on success, FALSE otherwise
+ */
+static int add_directory(FileList* list, const char* path) {
+    char entry_path[PATH_BUFFER_SIZE];
+    struct dirent* entry;
+    struct stat status;
+    DIR* directory;
+    int success = TRUE;
+
+    directory = opendir(path);
+    if (directory == NULL) {
+        printf("❌ Failed to open directory: %s\n", path);
+        return FALSE;
+    }
+
+    while (success && (entry = readdir(directory)) != NULL) {
+        int name_length = (int)strlen(entry->d_name);
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        if (strlen(path) + name_length + 2 > sizeof(entry_path)) {
+            printf("❌ Path is too long: %s/%s\n", path, entry->d_name);
+            success = FALSE;
+            break;
+        }
+        sprintf(entry_path, "%s%s%s", path, (path[strlen(path) - 1] == '/') ? "" : "/", entry->d_name);
+        if (lstat(entry_path, &status) != 0) {
+            continue;
+        }
+        if (S_ISDIR(status.st_mode)) {
+            success = add_directory(list, entry_path);
+        } else if (has_source_extension(entry->d_name, name_length) || is_bundle_name(entry->d_name)) {
+            /* The lstat above already has the size of a regular file; a symbolic link is followed */
+            success = add_name(list, entry_path, S_ISREG(status.st_mode) ? (long)status.st_size : -1L);
+        }
+    }
+
+    closedir(directory);
+    return success;
+}
+
+#endif /* FILE_LIST_DIRECTORIES */
+
+/**
+ * @brief Adds the inputs named by one argument
+ * @param list The file list
+ * @param argument The argument (base name, @response file or directory)
+ * @param depth The response file nesting depth
+ * @return TRUE on success, FALSE otherwise
+ */
+static int add_argument(FileList* list, const char* argument, int depth) {
+    if (argument[0] == '@') {
+        return add_response_file(list, argument + 1, depth);
+    }
+#ifdef FILE_LIST_DIRECTORIES
+    if (is_directory(argument)) {
+        return add_directory(list, argument);
+    }
+#endif
+    return add_name(list, argument, -1L);
+}
+
+/**
+ * @brief qsort comparator: larger files first, then by name
+ */
+static int compare_by_size(const void* a, const void* b) {
+    const SortEntry* first = (const SortEntry*)a;
+    const SortEntry* second = (const SortEntry*)b;
+    if (first->size != second->size) {
+        return (first->size > second->size) ? -1 : 1;
+    }
+    return strcmp(first->name, second->name);
+}
+
+/* --- Public Functions Implementation --- */
+
+int is_bundle_name(const char* name) {
+    int length = (int)strlen(name);
+    return length > BUNDLE_EXTENSION_LENGTH &&
+           strcmp(name + length - BUNDLE_EXTENSION_LENGTH, BUNDLE_EXTENSION) == 0;
+}
+
+void init_file_list(FileList* list) {
+    list->names = NULL;
+    list->sizes = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+int add_input_argument(FileList* list, const char* argument) {
+    return add_argument(list, argument, 0);
+}
+
+void sort_file_list_by_size(FileList* list) {
+    SortEntry* entries;
+    int i;
+
+    if (list->count < 2) {
+        return;
+    }
+    entries = (SortEntry*)malloc(list->count * sizeof(SortEntry));
+    if (entries == NULL) {
+        return;  /* Keep the original order */
+    }
+
+    for (i = 0; i < list->count; i++) {
+        entries[i].name = list->names[i];
+        entries[i].size = list->sizes[i];
+    }
+    qsort(entries, list->count, sizeof(SortEntry), compare_by_size);
+    for (i = 0; i < list->count; i++) {
+        list->names[i] = entries[i].name;
+        list->sizes[i] = entries[i].size;
+    }
+
+    free(entries);
+}
+
+void free_file_list(FileList* list) {
+    int i;
+    for (i = 0; i < list->count; i++) {
+        free(list->names[i]);
+    }
+    free(list->names);
+    free(list->sizes);
+    init_file_list(list);
+}
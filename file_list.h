@@ -0,0 +1,78 @@
+#ifndef ASSEMBLER_FILE_LIST_H
+#define ASSEMBLER_FILE_LIST_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes TRUE/FALSE and AS_EXTENSION */
+
+/**
+ * @brief This header file declares the list of input files of a run.
+ * Besides plain base names, an input argument may be a response file
+ * ("@list.txt", one input per line), a source bundle (".asb", see bundle.h)
+ * or a directory, which is searched recursively for .as and .asb files, so
+ * a single invocation can assemble a batch far larger than the shell
+ * command-line limit. The collected files are then
+ * ordered largest first, so the longest jobs start earliest.
+ */
+
+/**
+ * @brief Longest accepted base name; the passes build "<name>.as" in 256-byte buffers.
+ */
+#define MAX_INPUT_NAME_LENGTH 250
+
+/**
+ * @brief Deepest nesting of response files (a response file may name another one).
+ */
+#define MAX_RESPONSE_FILE_DEPTH 8
+
+/* --- File List Definitions --- */
+
+/**
+ * @brief The input files of a run, as base names without the .as extension
+ * (bundles keep their .asb extension).
+ */
+typedef struct {
+    char** names;       /* Base names of the input files */
+    long* sizes;        /* Sizes of the input files in bytes (-1 if unknown) */
+    int count;          /* Number of input files */
+    int capacity;       /* Capacity of the arrays */
+} FileList;
+
+/* --- File List Functions --- */
+
+/**
+ * @brief Initializes an empty file list.
+ * @param list The file list to initialize.
+ */
+void init_file_list(FileList* list);
+
+/**
+ * @brief Adds the inputs named by one command-line argument to a file list.
+ * The argument is a base name (an .as extension is accepted and removed),
+ * the path of a bundle, "@" followed by the path of a response file, or a directory.
+ * @param list The file list to add to.
+ * @param argument The command-line argument.
+ * @return TRUE on success, FALSE if a response file or directory could not be read
+ * (a message is printed).
+ */
+int add_input_argument(FileList* list, const char* argument);
+
+/**
+ * @brief Checks whether an input names a source bundle (ends with .asb).
+ * @param name The name of the input.
+ * @return TRUE if the input is a bundle, FALSE otherwise.
+ */
+int is_bundle_name(const char* name);
+
+/**
+ * @brief Orders a file list by file size, largest first (ties by name).
+ * @param list The file list to sort.
+ */
+void sort_file_list_by_size(FileList* list);
+
+/**
+ * @brief Releases a file list.
+ * @param list The file list to release.
+ */
+void free_file_list(FileList* list);
+
+#endif /* ASSEMBLER_FILE_LIST_H */
@@ -0,0 +1,256 @@
+#include "macro_library.h"
+#include "error_handler.h"
+
+#include <stdio.h>   /* For fopen, fread, fwrite */
+#include <stdlib.h>  /* For malloc, calloc, free */
+#include <string.h>  /* For strlen, memcmp */
+
+/* --- Library Format Constants --- */
+#define MLIB_MAGIC "MLIB"
+#define MLIB_FORMAT_VERSION 1
+#define MLIB_WORD_SIZE 4                    /* Every number is stored as 4 bytes */
+#define MLIB_HEADER_WORDS 4                 /* magic, version, macro count, slot count */
+#define MLIB_RECORD_WORDS 5                 /* hash, name offset, name length, body offset, body length */
+
+/* Offsets of the fields inside a record, in words */
+#define RECORD_HASH 0
+#define RECORD_NAME_OFFSET 1
+#define RECORD_NAME_LENGTH 2
+#define RECORD_BODY_OFFSET 3
+#define RECORD_BODY_LENGTH 4
+
+/* --- Global Variables for the Loaded Library --- */
+
+static unsigned char* g_library_data = NULL;    /* The whole library file */
+static unsigned long g_library_macro_count = 0; /* Number of macros in the library */
+static unsigned long g_library_slot_count = 0;  /* Number of index slots (a power of two) */
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Computes the FNV-1a hash of a macro name
+ * @param name The first character of the name
+ * @param length The number of characters to hash
+ * @return The 32-bit hash value
+ */
+static unsigned long hash_macro_name(const char* name, int length) {
+    unsigned long hash = 2166136261UL;
+    int i;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)name[i];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Reads a little-endian 32-bit number
+ * @param bytes The first byte of the number
+ * @return The number
+ */
+static unsigned long read_word(const unsigned char* bytes) {
+    return (unsigned long)bytes[0] | ((unsigned long)bytes[1] << 8) |
+           ((unsigned long)bytes[2] << 16) | ((unsigned long)bytes[3] << 24);
+}
+
+/**
+ * @brief Stores a little-endian 32-bit number
+ * @param bytes The first byte of the destination
+ * @param value The number to store
+ */
+static void store_word(unsigned char* bytes, unsigned long value) {
+    bytes[0] = (unsigned char)(value & 0xFF);
+    bytes[1] = (unsigned char)((value >> 8) & 0xFF);
+    bytes[2] = (unsigned char)((value >> 16) & 0xFF);
+    bytes[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+/**
+ * @brief Returns a pointer to a field of a macro record in the loaded library
+ * @param record The record number
+ * @param field The field offset inside the record, in words
+ * @return A pointer to the field
+ */
+static const unsigned char* record_field(unsigned long record, int field) {
+    return g_library_data + MLIB_WORD_SIZE * (MLIB_HEADER_WORDS + g_library_slot_count +
+                                              record * MLIB_RECORD_WORDS + field);
+}
+
+/**
+ * @brief Checks that every record of a freshly read library points inside the file
+ * @param size The size of the library file in bytes
+ * @return TRUE if all records are well-formed, FALSE otherwise
+ */
+static int validate_records(unsigned long size) {
+    unsigned long record;
+    for (record = 0; record < g_library_macro_count; record++) {
+        unsigned long name_offset = read_word(record_field(record, RECORD_NAME_OFFSET));
+        unsigned long name_length = read_word(record_field(record, RECORD_NAME_LENGTH));
+        unsigned long body_offset = read_word(record_field(record, RECORD_BODY_OFFSET));
+        unsigned long body_length = read_word(record_field(record, RECORD_BODY_LENGTH));
+
+        if (name_offset >= size || name_length >= size - name_offset ||
+            body_offset >= size || body_length >= size - body_offset ||
+            g_library_data[name_offset + name_length] != '\0' ||
+            g_library_data[body_offset + body_length] != '\0') {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* --- Public Functions Implementation --- */
+
+int write_macro_library(const char* library_path, const char* const names[], const char* const bodies[], int count) {
+    unsigned long slot_count = 1;
+    unsigned long table_size;
+    unsigned long string_offset;
+    unsigned char* table;
+    FILE* library_file;
+    int i;
+
+    /* Keep the index at most half full */
+    while (slot_count < (unsigned long)count * 2) {
+        slot_count *= 2;
+    }
+
+    /* Header, index and records are built in memory, strings are streamed after them */
+    table_size = MLIB_WORD_SIZE * (MLIB_HEADER_WORDS + slot_count + (unsigned long)count * MLIB_RECORD_WORDS);
+    table = (unsigned char*)calloc(table_size, 1);
+    if (table == NULL) {
+        return FALSE;
+    }
+
+    memcpy(table, MLIB_MAGIC, MLIB_WORD_SIZE);
+    store_word(table + MLIB_WORD_SIZE * 1, MLIB_FORMAT_VERSION);
+    store_word(table + MLIB_WORD_SIZE * 2, (unsigned long)count);
+    store_word(table + MLIB_WORD_SIZE * 3, slot_count);
+
+    string_offset = table_size;
+    for (i = 0; i < count; i++) {
+        unsigned long name_length = strlen(names[i]);
+        unsigned long body_length = strlen(bodies[i]);
+        unsigned long hash = hash_macro_name(names[i], (int)name_length);
+        unsigned long slot = hash & (slot_count - 1);
+        unsigned char* record = table + MLIB_WORD_SIZE * (MLIB_HEADER_WORDS + slot_count + (unsigned long)i * MLIB_RECORD_WORDS);
+
+        /* Linear probing for a free index slot */
+        while (read_word(table + MLIB_WORD_SIZE * (MLIB_HEADER_WORDS + slot)) != 0) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        store_word(table + MLIB_WORD_SIZE * (MLIB_HEADER_WORDS + slot), (unsigned long)i + 1);
+
+        store_word(record + MLIB_WORD_SIZE * RECORD_HASH, hash);
+        store_word(record + MLIB_WORD_SIZE * RECORD_NAME_OFFSET, string_offset);
+        store_word(record + MLIB_WORD_SIZE * RECORD_NAME_LENGTH, name_length);
+        string_offset += name_length + 1;
+        store_word(record + MLIB_WORD_SIZE * RECORD_BODY_OFFSET, string_offset);
+        store_word(record + MLIB_WORD_SIZE * RECORD_BODY_LENGTH, body_length);
+        string_offset += body_length + 1;
+    }
+
+    library_file = fopen(library_path, "wb");
+    if (library_file == NULL) {
+        free(table);
+        report_error(library_path, 0, ERROR_FILE_OPEN_FAILED);
+        return FALSE;
+    }
+
+    fwrite(table, 1, table_size, library_file);
+    for (i = 0; i < count; i++) {
+        fwrite(names[i], 1, strlen(names[i]) + 1, library_file);
+        fwrite(bodies[i], 1, strlen(bodies[i]) + 1, library_file);
+    }
+
+    free(table);
+    return fclose(library_file) == 0;
+}
+
+int load_macro_library(const char* library_path) {
+    FILE* library_file;
+    long file_size;
+    unsigned long size;
+
+    free_macro_library();
+
+    library_file = fopen(library_path, "rb");
+    if (library_file == NULL) {
+        report_error(library_path, 0, ERROR_FILE_OPEN_FAILED);
+        return FALSE;
+    }
+
+    /* Read the whole library with a single read */
+    fseek(library_file, 0, SEEK_END);
+    file_size = ftell(library_file);
+    fseek(library_file, 0, SEEK_SET);
+    if (file_size < MLIB_WORD_SIZE * MLIB_HEADER_WORDS) {
+        fclose(library_file);
+        report_error(library_path, 0, ERROR_INVALID_MACRO_LIBRARY);
+        return FALSE;
+    }
+    size = (unsigned long)file_size;
+
+    g_library_data = (unsigned char*)malloc(size);
+    if (g_library_data == NULL || fread(g_library_data, 1, size, library_file) != size) {
+        fclose(library_file);
+        free_macro_library();
+        report_error(library_path, 0, ERROR_INTERNAL_ERROR);
+        return FALSE;
+    }
+    fclose(library_file);
+
+    g_library_macro_count = read_word(g_library_data + MLIB_WORD_SIZE * 2);
+    g_library_slot_count = read_word(g_library_data + MLIB_WORD_SIZE * 3);
+
+    /* Check the header and that the index and records fit in the file */
+    if (memcmp(g_library_data, MLIB_MAGIC, MLIB_WORD_SIZE) != 0 ||
+        read_word(g_library_data + MLIB_WORD_SIZE) != MLIB_FORMAT_VERSION ||
+        g_library_slot_count == 0 || (g_library_slot_count & (g_library_slot_count - 1)) != 0 ||
+        g_library_slot_count < g_library_macro_count ||
+        g_library_slot_count > size / MLIB_WORD_SIZE - MLIB_HEADER_WORDS ||
+        (size / MLIB_WORD_SIZE - MLIB_HEADER_WORDS - g_library_slot_count) / MLIB_RECORD_WORDS < g_library_macro_count ||
+        !validate_records(size)) {
+        free_macro_library();
+        report_error(library_path, 0, ERROR_INVALID_MACRO_LIBRARY);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+const char* find_library_macro(const char* name, int length) {
+    unsigned long hash;
+    unsigned long slot;
+    unsigned long entry;
+    unsigned long record;
+    unsigned long probes;
+
+    if (g_library_data == NULL) {
+        return NULL;
+    }
+
+    hash = hash_macro_name(name, length);
+    slot = hash & (g_library_slot_count - 1);
+    for (probes = 0; probes < g_library_slot_count; probes++) {
+        entry = read_word(g_library_data + MLIB_WORD_SIZE * (MLIB_HEADER_WORDS + slot));
+        if (entry == 0) {
+            break;
+        }
+        record = entry - 1;
+        if (record < g_library_macro_count &&
+            read_word(record_field(record, RECORD_HASH)) == hash &&
+            read_word(record_field(record, RECORD_NAME_LENGTH)) == (unsigned long)length &&
+            memcmp(g_library_data + read_word(record_field(record, RECORD_NAME_OFFSET)), name, length) == 0) {
+            return (const char*)g_library_data + read_word(record_field(record, RECORD_BODY_OFFSET));
+        }
+        slot = (slot + 1) & (g_library_slot_count - 1);
+    }
+    return NULL;
+}
+
+void free_macro_library() {
+    free(g_library_data);
+    g_library_data = NULL;
+    g_library_macro_count = 0;
+    g_library_slot_count = 0;
+}
@@ -0,0 +1,58 @@
+#ifndef ASSEMBLER_MACRO_LIBRARY_H
+#define ASSEMBLER_MACRO_LIBRARY_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes global constants like MAX_LABEL_LENGTH */
+
+/**
+ * @brief This header file declares the precompiled macro library (.mlib) support.
+ * A macro library holds a set of 'mcro' definitions in a binary, position-independent
+ * layout: a header, an open-addressing hash index, fixed-size macro records and a
+ * string area with the interned names and the bodies (each body one null-terminated
+ * string of complete lines, newlines included, written out as is). Loading a library is a single read into one buffer plus a bounds
+ * check of the records; no source text is parsed, and lookups hash the call-site
+ * token straight into the index. The layout could equally be mapped into memory;
+ * it is read with one fread because libraries are small and are bounds-checked
+ * once at load anyway.
+ *
+ * File layout (every number is an unsigned 32-bit little-endian value):
+ *   header:  magic "MLIB", format version, macro count, index slot count
+ *   index:   slot count entries, each a record number + 1 (0 = empty slot)
+ *   records: macro count entries of {hash, name offset, name length, body offset, body length}
+ *   strings: names and bodies, each followed by a '\0'; offsets are from the file start
+ */
+
+/* --- Macro Library Functions --- */
+
+/**
+ * @brief Writes a set of macro definitions to a macro library file.
+ * @param library_path The path of the library file to create.
+ * @param names The macro names.
+ * @param bodies The macro bodies (complete lines, each ending with a newline).
+ * @param count The number of macros.
+ * @return TRUE if the library was written, FALSE otherwise.
+ */
+int write_macro_library(const char* library_path, const char* const names[], const char* const bodies[], int count);
+
+/**
+ * @brief Loads a macro library, replacing any previously loaded one.
+ * Errors (missing file, malformed or unsupported library) are reported through the error handler.
+ * @param library_path The path of the library file.
+ * @return TRUE if the library was loaded, FALSE otherwise.
+ */
+int load_macro_library(const char* library_path);
+
+/**
+ * @brief Looks up a macro in the loaded library.
+ * @param name A pointer to the first character of the macro name (need not be null-terminated).
+ * @param length The number of characters in the name.
+ * @return The null-terminated body of the macro, or NULL if no library is loaded or it has no such macro.
+ */
+const char* find_library_macro(const char* name, int length);
+
+/**
+ * @brief Releases the loaded macro library, if any.
+ */
+void free_macro_library();
+
+#endif /* ASSEMBLER_MACRO_LIBRARY_H */
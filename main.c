@@ -4,35 +4,99 @@
 
 #include "pre_assembler.h"
 #include "error_handler.h"
+#include "manifest.h"
+#include "macro_library.h"
+#include "statistics.h"
+#include "trace.h"
+#include "file_list.h"
+#include "bundle.h"
+#include "packfile.h"
+
+/* --- Command-Line Option Prefixes --- */
+#define OPTION_PREFIX "--"
+#define MANIFEST_OPTION "--manifest="
+#define MLIB_OPTION "--mlib="
+#define BUILD_MLIB_OPTION "--build-mlib="
+#define STATS_OPTION "--stats"
+#define STATS_COUNTERS_OPTION "--stats=counters"
+#define TRACE_OPTION "--trace="
+#define PACK_OPTION "--pack="
+#define CHECK_OPTION "--check"
 
 /**
- * @brief Simple main function to test the pre-assembler functionality.
- * Usage: ./assembler <file_name_without_extension>
- * Example: ./assembler tests/valid_macro_example_1
+ * @brief Prints the usage message of the assembler
+ * @param program_name The name the program was invoked with
  */
-int main(int argc, char* argv[]) {
-    const char* file_name;
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [--manifest=<file>] [--mlib=<library>] [--stats[=counters]] [--trace=<file.json>] [--pack=<file>] [--check] <input>...\n", program_name);
+    printf("       %s --build-mlib=<library> <input>...\n", program_name);
+    printf("An input is a file name without extension, a .asb bundle, @<response_file> or a directory.\n");
+    printf("Example: %s tests/valid_macro_example_1\n", program_name);
+}
+
+/**
+ * @brief Joins all command-line options into a single space-separated string
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return A newly allocated string (possibly empty), or NULL if memory allocation failed
+ */
+static char* join_options(int argc, char* argv[]) {
+    unsigned int total_length = 1;
+    char* flags;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0) {
+            total_length += strlen(argv[i]) + 1;
+        }
+    }
+
+    flags = (char*)malloc(total_length);
+    if (flags == NULL) {
+        return NULL;
+    }
+    flags[0] = '\0';
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0) {
+            if (flags[0] != '\0') {
+                strcat(flags, " ");
+            }
+            strcat(flags, argv[i]);
+        }
+    }
+    return flags;
+}
+
+/* Whether the run only validates its inputs (--check) */
+static int g_check_mode = FALSE;
+
+/**
+ * @brief Runs the pre-assembler on one file and reports the result
+ * @param file_name The base name of the input file (without the .as extension)
+ * @return TRUE if the file was processed successfully, FALSE otherwise
+ */
+static int process_file(const char* file_name) {
     int success;
     char am_file_name[256];
     FILE* test_file;
-    
-    if (argc != 2) {
-        printf("Usage: %s <file_name_without_extension>\n", argv[0]);
-        printf("Example: %s tests/valid_macro_example_1\n", argv[0]);
-        return 1;
-    }
 
-    file_name = argv[1];
-    
     printf("Starting pre-assembly for file: %s\n", file_name);
-    
+
     /* Process the file through pre-assembler */
+    trace_begin(file_name, "file");
     success = process_pre_assembly_for_file(file_name);
-    
-    if (success) {
+    trace_end(file_name, "file");
+
+    if (success && g_check_mode) {
+        printf("✅ Check passed: no errors found\n");
+    } else if (success) {
         printf("✅ Pre-assembly completed successfully!\n");
+        if (is_packfile_open()) {
+            printf("📦 Packed output: %s.am\n", file_name);
+            return TRUE;
+        }
         printf("📁 Generated file: %s.am\n", file_name);
-        
+
         /* Check if .am file was created */
         sprintf(am_file_name, "%s.am", file_name);
         test_file = fopen(am_file_name, "r");
@@ -41,15 +105,218 @@ int main(int argc, char* argv[]) {
             fclose(test_file);
         } else {
             printf("❌ .am file was not created or is not readable\n");
-            return 1;
+            return FALSE;
         }
     } else {
         printf("❌ Pre-assembly failed!\n");
         if (has_errors()) {
             printf("Errors were detected during processing.\n");
         }
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Runs the pre-assembler on every member of a source bundle
+ * Each member is processed in its own context, exactly as if it were a separate file.
+ * @param bundle_path The path of the bundle file
+ * @return TRUE if every member was processed successfully, FALSE otherwise
+ */
+static int process_bundle(const char* bundle_path) {
+    Bundle bundle;
+    SourceBuffer member_source;
+    int success;
+    int all_succeeded = TRUE;
+    int i;
+
+    printf("Reading source bundle: %s\n", bundle_path);
+    trace_begin(bundle_path, "file");
+    begin_stage(STAGE_SOURCE_READ);
+    if (!load_bundle(&bundle, bundle_path)) {
+        end_stage(STAGE_SOURCE_READ);
+        trace_end(bundle_path, "file");
+        printf("❌ Failed to read source bundle!\n");
+        return FALSE;
+    }
+    end_stage(STAGE_SOURCE_READ);
+
+    for (i = 0; i < bundle.member_count; i++) {
+        const char* member_name = bundle.members[i].name;
+        const char* span_name = trace_name(member_name);
+        printf("Starting pre-assembly for bundle member: %s\n", member_name);
+        get_bundle_member(&bundle, i, &member_source);
+        trace_begin(span_name, "file");
+        success = process_pre_assembly_for_source(member_name, &member_source);
+        trace_end(span_name, "file");
+        if (success && g_check_mode) {
+            printf("✅ Check passed: no errors found\n");
+        } else if (success) {
+            printf("✅ Pre-assembly completed successfully!\n");
+            printf("%s %s.am\n", is_packfile_open() ? "📦 Packed output:" : "📁 Generated file:", member_name);
+        } else {
+            printf("❌ Pre-assembly failed!\n");
+            all_succeeded = FALSE;
+        }
+    }
+    trace_end(bundle_path, "file");
+
+    free_bundle(&bundle);
+    return all_succeeded;
+}
+
+/**
+ * @brief Compiles the macro definitions of the input files into a macro library
+ * @param library_path The path of the library file to create
+ * @param inputs The input files
+ * @return TRUE if the library was written, FALSE otherwise
+ */
+static int build_library(const char* library_path, const FileList* inputs) {
+    int success = build_macro_library(library_path, inputs->names, inputs->count);
+    if (success) {
+        printf("✅ Macro library written: %s\n", library_path);
+    } else {
+        printf("❌ Macro library was not written!\n");
+    }
+    return success;
+}
+
+/**
+ * @brief Simple main function to test the pre-assembler functionality.
+ * Usage: ./assembler [--manifest=<file>] [--mlib=<library>] [--stats[=counters]] [--trace=<file.json>] [--pack=<file>] [--check] <input>...
+ * Example: ./assembler tests/valid_macro_example_1
+ * An input is a file name without extension, a source bundle (.asb, see
+ * bundle.h), @<response_file> (one input per line) or a directory searched
+ * recursively for .as and .asb files. The inputs are
+ * processed largest file first.
+ * With --manifest, every input and output file of the run is listed with its
+ * size and content hash in the given manifest file.
+ * With --mlib, the macros of a precompiled library are available to every file;
+ * --build-mlib compiles the macro definitions of the input files into such a library.
+ * With --stats, the time spent in each stage is printed at the end of the run;
+ * --stats=counters adds the hardware performance counters of each stage (Linux).
+ * With --trace, a timeline of every file and stage is written as Chrome
+ * trace-event JSON (open it in chrome://tracing or Perfetto).
+ * With --pack, all output files are written into one packfile (see packfile.h)
+ * instead of separate files; extract_pack lists and extracts them.
+ * With --check, the inputs are only validated: every error is reported, but
+ * no output file is written.
+ */
+int main(int argc, char* argv[]) {
+    const char* manifest_path = NULL;
+    const char* library_path = NULL;
+    const char* build_library_path = NULL;
+    const char* trace_path = NULL;
+    const char* pack_path = NULL;
+    int stats_mode = FALSE;
+    int stats_counters = FALSE;
+    FileList inputs;
+    int all_succeeded = TRUE;
+    int i;
+
+    init_file_list(&inputs);
+
+    /* Parse options */
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], MANIFEST_OPTION, strlen(MANIFEST_OPTION)) == 0) {
+            manifest_path = argv[i] + strlen(MANIFEST_OPTION);
+        } else if (strncmp(argv[i], MLIB_OPTION, strlen(MLIB_OPTION)) == 0) {
+            library_path = argv[i] + strlen(MLIB_OPTION);
+        } else if (strncmp(argv[i], BUILD_MLIB_OPTION, strlen(BUILD_MLIB_OPTION)) == 0) {
+            build_library_path = argv[i] + strlen(BUILD_MLIB_OPTION);
+        } else if (strcmp(argv[i], STATS_OPTION) == 0) {
+            stats_mode = TRUE;
+        } else if (strcmp(argv[i], STATS_COUNTERS_OPTION) == 0) {
+            stats_mode = TRUE;
+            stats_counters = TRUE;
+        } else if (strncmp(argv[i], TRACE_OPTION, strlen(TRACE_OPTION)) == 0) {
+            trace_path = argv[i] + strlen(TRACE_OPTION);
+        } else if (strcmp(argv[i], CHECK_OPTION) == 0) {
+            g_check_mode = TRUE;
+        } else if (strncmp(argv[i], PACK_OPTION, strlen(PACK_OPTION)) == 0) {
+            pack_path = argv[i] + strlen(PACK_OPTION);
+        } else if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0) {
+            printf("Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            free_file_list(&inputs);
+            return 1;
+        } else if (!add_input_argument(&inputs, argv[i])) {
+            free_file_list(&inputs);
+            return 1;
+        }
+    }
+
+    if (inputs.count == 0) {
+        print_usage(argv[0]);
         return 1;
     }
-    
-    return 0;
-} 
\ No newline at end of file
+    sort_file_list_by_size(&inputs);
+
+    if (build_library_path != NULL) {
+        all_succeeded = build_library(build_library_path, &inputs);
+        free_file_list(&inputs);
+        return all_succeeded ? 0 : 1;
+    }
+
+    if (library_path != NULL && !load_macro_library(library_path)) {
+        printf("❌ Failed to load macro library: %s\n", library_path);
+        free_file_list(&inputs);
+        return 1;
+    }
+
+    if (manifest_path != NULL) {
+        char* flags = join_options(argc, argv);
+        begin_manifest(flags != NULL ? flags : "");
+        free(flags);
+    }
+
+    if (stats_mode) {
+        enable_statistics(stats_counters);
+    }
+
+    if (trace_path != NULL) {
+        enable_trace();
+    }
+
+    set_pre_assembly_check_only(g_check_mode);
+
+    if (pack_path != NULL && !open_packfile(pack_path)) {
+        printf("❌ Failed to create packfile: %s\n", pack_path);
+        free_macro_library();
+        free_file_list(&inputs);
+        return 1;
+    }
+
+    /* Process every input file, even after a failure */
+    for (i = 0; i < inputs.count; i++) {
+        int success = is_bundle_name(inputs.names[i]) ? process_bundle(inputs.names[i])
+                                                      : process_file(inputs.names[i]);
+        if (!success) {
+            all_succeeded = FALSE;
+        }
+    }
+
+    free_macro_library();
+    print_statistics();
+
+    if (pack_path != NULL && !close_packfile()) {
+        printf("❌ Failed to write packfile: %s\n", pack_path);
+        all_succeeded = FALSE;
+    }
+
+    /* The trace refers to the input names, so it is written before they are released */
+    if (trace_path != NULL && !write_trace(trace_path)) {
+        printf("❌ Failed to write trace file: %s\n", trace_path);
+        free_file_list(&inputs);
+        return 1;
+    }
+    free_file_list(&inputs);
+
+    if (manifest_path != NULL && !write_manifest(manifest_path)) {
+        printf("❌ Failed to write manifest file: %s\n", manifest_path);
+        return 1;
+    }
+
+    return all_succeeded ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include "manifest.h"
+
+#include <stdlib.h>  /* For malloc, realloc, free */
+#include <string.h>  /* For strlen, strcpy */
+
+/* --- Constants for FNV-1a Hashing --- */
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+#define HASH_MASK 0xFFFFFFFFUL  /* Keep the hash 32 bits wide on every platform */
+
+/* --- Manifest Structures --- */
+
+/**
+ * @brief Structure to represent one file listed in the manifest
+ */
+typedef struct {
+    char* kind;             /* "input" or "output" */
+    char* path;             /* Path of the file */
+    unsigned long size;     /* Size of the file in bytes */
+    unsigned long hash;     /* FNV-1a hash of the file contents */
+} ManifestEntry;
+
+/* --- Global Variables for Manifest Collection --- */
+
+static int g_manifest_enabled = FALSE;          /* Whether entries are being collected */
+static char* g_manifest_flags = NULL;           /* Flags of the run */
+static ManifestEntry* g_entries = NULL;         /* Collected entries */
+static int g_entry_count = 0;                   /* Number of collected entries */
+static int g_entry_capacity = 0;                /* Capacity of the entries array */
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Adds bytes to the running hash and size of a tracked file
+ * @param tracked The tracked file
+ * @param data The bytes to add
+ * @param length The number of bytes
+ */
+static void track_bytes(TrackedFile* tracked, const char* data, unsigned long length) {
+    unsigned long hash = tracked->hash;
+    unsigned long i;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)data[i];
+        hash = (hash * FNV_PRIME) & HASH_MASK;
+    }
+    tracked->hash = hash;
+    tracked->size += length;
+}
+
+/**
+ * @brief Allocates a copy of a string
+ * @param str The string to copy
+ * @return The copy, or NULL if memory allocation failed
+ */
+static char* copy_string(const char* str) {
+    char* copy = (char*)malloc(strlen(str) + 1);
+    if (copy != NULL) {
+        strcpy(copy, str);
+    }
+    return copy;
+}
+
+/**
+ * @brief Appends an entry to the manifest
+ * @param kind The role of the file
+ * @param path The path of the file
+ * @param size The size of the file in bytes
+ * @param hash The hash of the file contents
+ */
+static void add_entry(const char* kind, const char* path, unsigned long size, unsigned long hash) {
+    ManifestEntry* entry;
+
+    if (g_entry_count >= g_entry_capacity) {
+        int new_capacity = (g_entry_capacity == 0) ? 16 : g_entry_capacity * 2;
+        ManifestEntry* new_entries = (ManifestEntry*)realloc(g_entries, new_capacity * sizeof(ManifestEntry));
+        if (new_entries == NULL) {
+            return;
+        }
+        g_entries = new_entries;
+        g_entry_capacity = new_capacity;
+    }
+
+    entry = &g_entries[g_entry_count];
+    entry->kind = copy_string(kind);
+    entry->path = copy_string(path);
+    entry->size = size;
+    entry->hash = hash;
+    g_entry_count++;
+}
+
+/**
+ * @brief Releases all collected entries and stops collecting
+ */
+static void free_manifest() {
+    int i;
+    for (i = 0; i < g_entry_count; i++) {
+        free(g_entries[i].kind);
+        free(g_entries[i].path);
+    }
+    free(g_entries);
+    free(g_manifest_flags);
+    g_entries = NULL;
+    g_entry_count = 0;
+    g_entry_capacity = 0;
+    g_manifest_flags = NULL;
+    g_manifest_enabled = FALSE;
+}
+
+/* --- Public Functions Implementation --- */
+
+int tracked_open(TrackedFile* tracked, const char* path, const char* mode) {
+    tracked->file = fopen(path, mode);
+    tracked->size = 0;
+    tracked->hash = FNV_OFFSET_BASIS;
+    tracked->shared = FALSE;
+    return tracked->file != NULL;
+}
+
+void tracked_attach(TrackedFile* tracked, FILE* stream) {
+    tracked->file = stream;
+    tracked->size = 0;
+    tracked->hash = FNV_OFFSET_BASIS;
+    tracked->shared = TRUE;
+}
+
+unsigned long tracked_read(char* buffer, unsigned long length, TrackedFile* tracked) {
+    unsigned long read_length = (unsigned long)fread(buffer, 1, length, tracked->file);
+    track_bytes(tracked, buffer, read_length);
+    return read_length;
+}
+
+void tracked_write(const char* data, unsigned long length, TrackedFile* tracked) {
+    fwrite(data, 1, length, tracked->file);
+    track_bytes(tracked, data, length);
+}
+
+void tracked_puts(const char* str, TrackedFile* tracked) {
+    tracked_write(str, strlen(str), tracked);
+}
+
+void tracked_close(TrackedFile* tracked, const char* kind, const char* path) {
+    if (tracked->file == NULL) {
+        return;
+    }
+    if (!tracked->shared) {
+        fclose(tracked->file);
+    }
+    tracked->file = NULL;
+    if (g_manifest_enabled) {
+        add_entry(kind, path, tracked->size, tracked->hash);
+    }
+}
+
+void begin_manifest(const char* flags) {
+    free_manifest();
+    g_manifest_flags = copy_string(flags);
+    g_manifest_enabled = TRUE;
+}
+
+int write_manifest(const char* manifest_path) {
+    FILE* manifest_file;
+    int i;
+
+    manifest_file = fopen(manifest_path, "w");
+    if (manifest_file == NULL) {
+        free_manifest();
+        return FALSE;
+    }
+
+    fprintf(manifest_file, "version %s\n", ASSEMBLER_VERSION);
+    fprintf(manifest_file, "flags %s\n", g_manifest_flags != NULL ? g_manifest_flags : "");
+    for (i = 0; i < g_entry_count; i++) {
+        fprintf(manifest_file, "%s %lu %08lx %s\n",
+                g_entries[i].kind, g_entries[i].size, g_entries[i].hash, g_entries[i].path);
+    }
+
+    fclose(manifest_file);
+    free_manifest();
+    return TRUE;
+}
@@ -0,0 +1,96 @@
+#ifndef ASSEMBLER_MANIFEST_H
+#define ASSEMBLER_MANIFEST_H
+
+/* Include necessary standard libraries and project definitions */
+#include <stdio.h>   /* For FILE* operations */
+
+#include "definitions.h" /* Includes global constants like ASSEMBLER_VERSION */
+
+/**
+ * @brief This header file declares the content-hash manifest of an assembler run.
+ * Every input read and every output written is tracked while it streams through the
+ * assembler, accumulating its size and a fast non-cryptographic hash (32-bit FNV-1a),
+ * so the manifest never has to reread or stat a file. At the end of the run the
+ * manifest lists every file together with the assembler version and flags, and
+ * downstream build steps can skip unchanged artifacts.
+ */
+
+/* --- Tracked File Definitions --- */
+
+/**
+ * @brief An open file whose size and content hash are accumulated as it is read or written.
+ */
+typedef struct {
+    FILE* file;             /* The underlying stream */
+    unsigned long size;     /* Number of bytes read or written so far */
+    unsigned long hash;     /* FNV-1a hash of those bytes */
+    int shared;             /* TRUE if the stream belongs to someone else (e.g. a packfile) */
+} TrackedFile;
+
+/* --- Tracked I/O Functions --- */
+
+/**
+ * @brief Opens a file and starts tracking its size and hash.
+ * @param tracked The tracked file to initialize.
+ * @param path The path of the file to open.
+ * @param mode The fopen mode string.
+ * @return TRUE if the file was opened, FALSE otherwise.
+ */
+int tracked_open(TrackedFile* tracked, const char* path, const char* mode);
+
+/**
+ * @brief Starts tracking writes to a stream that stays open after tracked_close.
+ * @param tracked The tracked file to initialize.
+ * @param stream The open stream to write to.
+ */
+void tracked_attach(TrackedFile* tracked, FILE* stream);
+
+/**
+ * @brief Reads bytes from a tracked file (like fread) and adds them to the hash.
+ * @param buffer The buffer that receives the bytes.
+ * @param length The maximum number of bytes to read.
+ * @param tracked The tracked file to read from.
+ * @return The number of bytes read (0 at end of file).
+ */
+unsigned long tracked_read(char* buffer, unsigned long length, TrackedFile* tracked);
+
+/**
+ * @brief Writes bytes to a tracked file (like fwrite) and adds them to the hash.
+ * @param data The bytes to write.
+ * @param length The number of bytes to write.
+ * @param tracked The tracked file to write to.
+ */
+void tracked_write(const char* data, unsigned long length, TrackedFile* tracked);
+
+/**
+ * @brief Writes a null-terminated string to a tracked file (like fputs).
+ * @param str The string to write.
+ * @param tracked The tracked file to write to.
+ */
+void tracked_puts(const char* str, TrackedFile* tracked);
+
+/**
+ * @brief Closes a tracked file and, if a manifest is being collected, records it.
+ * An attached stream (see tracked_attach) is left open.
+ * @param tracked The tracked file to close.
+ * @param kind The role of the file in the manifest ("input" or "output").
+ * @param path The path of the file, as it should appear in the manifest.
+ */
+void tracked_close(TrackedFile* tracked, const char* kind, const char* path);
+
+/* --- Manifest Functions --- */
+
+/**
+ * @brief Starts collecting manifest entries for this run.
+ * @param flags The command-line flags of the run, recorded in the manifest.
+ */
+void begin_manifest(const char* flags);
+
+/**
+ * @brief Writes all collected entries to the manifest file and releases them.
+ * @param manifest_path The path of the manifest file to write.
+ * @return TRUE if the manifest was written, FALSE otherwise.
+ */
+int write_manifest(const char* manifest_path);
+
+#endif /* ASSEMBLER_MANIFEST_H */
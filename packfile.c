@@ -0,0 +1,152 @@
+#include "packfile.h"
+
+#include <stdio.h>   /* For fopen, fwrite, fclose */
+#include <stdlib.h>  /* For malloc, realloc, free */
+#include <string.h>  /* For strlen, memcpy */
+
+/* --- Packfile Structures --- */
+
+/**
+ * @brief Structure to represent one member written to the packfile
+ */
+typedef struct {
+    char* name;             /* Output path of the member */
+    unsigned long offset;   /* Offset of its contents in the packfile */
+    unsigned long size;     /* Size of its contents in bytes */
+    unsigned long hash;     /* FNV-1a hash of its contents */
+} PackMember;
+
+/* --- Global Variables for the Open Packfile --- */
+
+static FILE* g_pack_file = NULL;            /* The open packfile, or NULL */
+static unsigned long g_pack_offset = 0;     /* Bytes of member contents written so far */
+static PackMember* g_members = NULL;        /* Members written so far */
+static int g_member_count = 0;              /* Number of members */
+static int g_member_capacity = 0;           /* Capacity of the members array */
+static int g_pack_failed = FALSE;           /* A member could not be recorded in the index */
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Writes a little-endian 32-bit number to the packfile
+ * @param value The number to write
+ */
+static void write_word(unsigned long value) {
+    unsigned char bytes[PACK_WORD_SIZE];
+    bytes[0] = (unsigned char)(value & 0xFF);
+    bytes[1] = (unsigned char)((value >> 8) & 0xFF);
+    bytes[2] = (unsigned char)((value >> 16) & 0xFF);
+    bytes[3] = (unsigned char)((value >> 24) & 0xFF);
+    fwrite(bytes, 1, PACK_WORD_SIZE, g_pack_file);
+}
+
+/**
+ * @brief Releases the member list
+ */
+static void free_members() {
+    int i;
+    for (i = 0; i < g_member_count; i++) {
+        free(g_members[i].name);
+    }
+    free(g_members);
+    g_members = NULL;
+    g_member_count = 0;
+    g_member_capacity = 0;
+}
+
+/* --- Public Functions Implementation --- */
+
+int open_packfile(const char* pack_path) {
+    free_members();
+    g_pack_offset = 0;
+    g_pack_failed = FALSE;
+    g_pack_file = fopen(pack_path, "wb");
+    return g_pack_file != NULL;
+}
+
+int is_packfile_open() {
+    return g_pack_file != NULL;
+}
+
+int open_output_file(TrackedFile* tracked, const char* path) {
+    if (g_pack_file == NULL) {
+        return tracked_open(tracked, path, "w");
+    }
+    tracked_attach(tracked, g_pack_file);
+    return TRUE;
+}
+
+void close_output_file(TrackedFile* tracked, const char* path) {
+    PackMember* member;
+
+    if (tracked->file == NULL) {
+        return;
+    }
+    if (!tracked->shared) {
+        tracked_close(tracked, "output", path);
+        return;
+    }
+
+    /* Record the member that was just appended to the packfile; its bytes are
+     * in the pack either way, so the offset advances even if recording fails */
+    if (g_member_count >= g_member_capacity) {
+        int new_capacity = (g_member_capacity == 0) ? 64 : g_member_capacity * 2;
+        PackMember* new_members = (PackMember*)realloc(g_members, new_capacity * sizeof(PackMember));
+        if (new_members != NULL) {
+            g_members = new_members;
+            g_member_capacity = new_capacity;
+        }
+    }
+    member = (g_member_count < g_member_capacity) ? &g_members[g_member_count] : NULL;
+    if (member != NULL) {
+        member->name = (char*)malloc(strlen(path) + 1);
+    }
+    if (member == NULL || member->name == NULL) {
+        g_pack_failed = TRUE;
+    } else {
+        strcpy(member->name, path);
+        member->offset = g_pack_offset;
+        member->size = tracked->size;
+        member->hash = tracked->hash;
+        g_member_count++;
+    }
+    g_pack_offset += tracked->size;
+
+    tracked_close(tracked, "output", path);
+}
+
+int close_packfile() {
+    unsigned long index_offset = g_pack_offset;
+    unsigned long name_offset;
+    int success;
+    int i;
+
+    if (g_pack_file == NULL) {
+        return FALSE;
+    }
+
+    /* Index records, then the names they point to, then the trailer */
+    name_offset = index_offset + (unsigned long)g_member_count * PACK_RECORD_WORDS * PACK_WORD_SIZE;
+    for (i = 0; i < g_member_count; i++) {
+        unsigned long name_length = (unsigned long)strlen(g_members[i].name);
+        write_word(name_offset);
+        write_word(name_length);
+        write_word(g_members[i].offset);
+        write_word(g_members[i].size);
+        write_word(g_members[i].hash);
+        name_offset += name_length + 1;
+    }
+    for (i = 0; i < g_member_count; i++) {
+        fwrite(g_members[i].name, 1, strlen(g_members[i].name) + 1, g_pack_file);
+    }
+    fwrite(PACK_MAGIC, 1, PACK_WORD_SIZE, g_pack_file);
+    write_word(PACK_FORMAT_VERSION);
+    write_word((unsigned long)g_member_count);
+    write_word(index_offset);
+
+    success = !g_pack_failed && !ferror(g_pack_file);
+    success = (fclose(g_pack_file) == 0) && success;
+    g_pack_file = NULL;
+    free_members();
+    return success;
+}
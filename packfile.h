@@ -0,0 +1,68 @@
+#ifndef ASSEMBLER_PACKFILE_H
+#define ASSEMBLER_PACKFILE_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes TRUE/FALSE */
+#include "manifest.h"    /* Includes TrackedFile */
+
+/**
+ * @brief This header file declares the output packfile of the --pack mode.
+ * Instead of creating one file per output, every output of the run is appended
+ * to a single packfile, written strictly sequentially; the index is written
+ * once, at the end. A 5,000-file batch then creates one file instead of
+ * thousands, and readers locate members through the index without any
+ * per-file metadata. The extract_pack tool lists and extracts members.
+ *
+ * File layout (every number is an unsigned 32-bit little-endian value):
+ *   members: the contents of every output, back to back, from offset 0
+ *   index:   member count entries of {name offset, name length, data offset, data size, hash}
+ *   names:   the member names (output paths), each followed by a '\0'
+ *   trailer: magic "PACK", format version, member count, index offset
+ * The hash is the 32-bit FNV-1a hash of the member contents, as in the manifest;
+ * offsets are from the file start, and the trailer is the last 16 bytes.
+ */
+
+#define PACK_MAGIC "PACK"
+#define PACK_FORMAT_VERSION 1
+#define PACK_WORD_SIZE 4        /* Every number is stored as 4 bytes */
+#define PACK_RECORD_WORDS 5     /* name offset, name length, data offset, data size, hash */
+#define PACK_TRAILER_WORDS 4    /* magic, version, member count, index offset */
+
+/* --- Packfile Functions --- */
+
+/**
+ * @brief Creates a packfile; until it is closed, every output is written into it.
+ * @param pack_path The path of the packfile to create.
+ * @return TRUE if the packfile was created, FALSE otherwise.
+ */
+int open_packfile(const char* pack_path);
+
+/**
+ * @brief Checks whether outputs are currently written into a packfile.
+ * @return TRUE if a packfile is open, FALSE otherwise.
+ */
+int is_packfile_open();
+
+/**
+ * @brief Opens an output file, or starts a new member if a packfile is open.
+ * @param tracked The tracked file to initialize.
+ * @param path The path of the output file (the member name in a packfile).
+ * @return TRUE on success, FALSE otherwise.
+ */
+int open_output_file(TrackedFile* tracked, const char* path);
+
+/**
+ * @brief Closes an output opened with open_output_file (does nothing if it is not open).
+ * @param tracked The tracked output file.
+ * @param path The path of the output file, as passed to open_output_file.
+ */
+void close_output_file(TrackedFile* tracked, const char* path);
+
+/**
+ * @brief Writes the index and the trailer of the open packfile and closes it.
+ * @return TRUE if the packfile was completed, FALSE otherwise (including when a
+ * member could not be recorded in the index).
+ */
+int close_packfile();
+
+#endif /* ASSEMBLER_PACKFILE_H */
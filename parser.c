@@ -1 +1,219 @@
- 
\ No newline at end of file
+#include "parser.h"
+
+#include <string.h>  /* For strncmp, memcpy */
+
+/* --- Dispatch Table Definitions --- */
+
+/**
+ * @brief Classes of the first non-whitespace character of a statement.
+ */
+typedef enum {
+    LEAD_END = 0,       /* End of line ('\0', '\n', '\r') */
+    LEAD_COMMENT,       /* ';' */
+    LEAD_DIRECTIVE,     /* '.' */
+    LEAD_LETTER,        /* 'a'-'z', 'A'-'Z' */
+    LEAD_OTHER,         /* Anything else */
+    NUM_LEAD_CLASSES
+} LeadClass;
+
+/**
+ * @brief Handler that classifies a statement starting at its first non-whitespace character.
+ */
+typedef StatementKind (*StatementHandler)(const char* start, Statement* statement, int allow_label);
+
+/* Class of every possible first byte, filled once by init_lead_classes */
+static unsigned char lead_classes[256];
+static int lead_classes_ready = FALSE;
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Fills the first-byte class table
+ */
+static void init_lead_classes() {
+    int c;
+    for (c = 0; c < 256; c++) {
+        if (c == '\0' || c == '\n' || c == '\r') {
+            lead_classes[c] = LEAD_END;
+        } else if (c == ';') {
+            lead_classes[c] = LEAD_COMMENT;
+        } else if (c == '.') {
+            lead_classes[c] = LEAD_DIRECTIVE;
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            lead_classes[c] = LEAD_LETTER;
+        } else {
+            lead_classes[c] = LEAD_OTHER;
+        }
+    }
+    lead_classes_ready = TRUE;
+}
+
+/**
+ * @brief Returns the end of the token starting at the given position
+ * A token ends at whitespace, at the end of the line, or at a ',' or ';'.
+ * @param start The first character of the token
+ * @return A pointer just past the last character of the token
+ */
+static const char* scan_token(const char* start) {
+    const char* end = start;
+    while (*end != '\0' && !is_whitespace(*end) && *end != ',' && *end != ';') {
+        end++;
+    }
+    return end;
+}
+
+/**
+ * @brief Records the first token of the statement and the position that follows it
+ * @param statement The statement being classified
+ * @param start The first character of the token
+ * @param end A pointer just past the last character of the token
+ */
+static void set_token(Statement* statement, const char* start, const char* end) {
+    statement->token = start;
+    statement->token_length = (int)(end - start);
+    statement->rest = skip_whitespace((char*)end);
+}
+
+static StatementKind dispatch_statement(const char* line, Statement* statement, int allow_label);
+
+/* --- Statement Handlers --- */
+
+/**
+ * @brief Handles a line that ends before any statement starts
+ */
+static StatementKind handle_end(const char* start, Statement* statement, int allow_label) {
+    (void)start;
+    /* A label followed by nothing is not a valid statement */
+    return allow_label ? STATEMENT_EMPTY : STATEMENT_INVALID;
+}
+
+/**
+ * @brief Handles a comment line
+ */
+static StatementKind handle_comment(const char* start, Statement* statement, int allow_label) {
+    (void)start;
+    return allow_label ? STATEMENT_COMMENT : STATEMENT_INVALID;
+}
+
+/**
+ * @brief Handles a statement starting with '.'
+ */
+static StatementKind handle_directive(const char* start, Statement* statement, int allow_label) {
+    (void)allow_label;
+    set_token(statement, start, scan_token(start));
+    return STATEMENT_DIRECTIVE;
+}
+
+/**
+ * @brief Handles a statement starting with a letter: label, keyword or identifier
+ * The token length selects which keywords need to be compared at all.
+ */
+static StatementKind handle_letter(const char* start, Statement* statement, int allow_label) {
+    const char* end = start;
+    int length;
+
+    while (is_alphanumeric(*end)) {
+        end++;
+    }
+    length = (int)(end - start);
+
+    /* Label definition: classify the statement that follows it */
+    if (*end == ':' && allow_label) {
+        statement->label = start;
+        statement->label_length = length;
+        return dispatch_statement(end + 1, statement, FALSE);
+    }
+
+    end = scan_token(end);
+    length = (int)(end - start);
+    set_token(statement, start, end);
+
+    switch (length) {
+        case 3:
+        case 4:
+            if (length == 4 && strncmp(start, "mcro", 4) == 0) {
+                return STATEMENT_MACRO_START;
+            }
+            {
+                char op_name[5];
+                memcpy(op_name, start, length);
+                op_name[length] = '\0';
+                if (get_opcode_value(op_name, &statement->opcode)) {
+                    return STATEMENT_INSTRUCTION;
+                }
+            }
+            break;
+        case 7:
+            if (strncmp(start, "mcroend", 7) == 0) {
+                return STATEMENT_MACRO_END;
+            }
+            break;
+        default:
+            break;
+    }
+    return STATEMENT_IDENTIFIER;
+}
+
+/**
+ * @brief Handles a statement starting with a character that cannot start any statement
+ */
+static StatementKind handle_other(const char* start, Statement* statement, int allow_label) {
+    (void)allow_label;
+    set_token(statement, start, scan_token(start));
+    return STATEMENT_INVALID;
+}
+
+/* Handler for each first-byte class, indexed by LeadClass */
+static const StatementHandler statement_handlers[NUM_LEAD_CLASSES] = {
+    handle_end, handle_comment, handle_directive, handle_letter, handle_other
+};
+
+/**
+ * @brief Skips whitespace and dispatches on the first significant byte
+ * @param line The position to classify from
+ * @param statement The statement being classified
+ * @param allow_label FALSE once a label has already been consumed
+ * @return The kind of the statement
+ */
+static StatementKind dispatch_statement(const char* line, Statement* statement, int allow_label) {
+    const char* start = skip_whitespace((char*)line);
+    return statement_handlers[lead_classes[(unsigned char)*start]](start, statement, allow_label);
+}
+
+/* --- Public Functions Implementation --- */
+
+StatementKind classify_statement(const char* line, Statement* statement) {
+    if (!lead_classes_ready) {
+        init_lead_classes();
+    }
+
+    statement->label = NULL;
+    statement->label_length = 0;
+    statement->token = NULL;
+    statement->token_length = 0;
+    statement->rest = NULL;
+    statement->opcode = -1;
+
+    statement->kind = dispatch_statement(line, statement, TRUE);
+    return statement->kind;
+}
+
+void record_statement(const Statement* statement, const char* line, LineRecord* record) {
+    record->kind = statement->kind;
+    record->opcode = statement->opcode;
+    record->label_offset = (statement->label != NULL) ? (int)(statement->label - line) : -1;
+    record->label_length = statement->label_length;
+    record->token_offset = (statement->token != NULL) ? (int)(statement->token - line) : -1;
+    record->token_length = statement->token_length;
+    record->rest_offset = (statement->rest != NULL) ? (int)(statement->rest - line) : -1;
+}
+
+void restore_statement(const LineRecord* record, const char* line, Statement* statement) {
+    statement->kind = record->kind;
+    statement->opcode = record->opcode;
+    statement->label = (record->label_offset >= 0) ? line + record->label_offset : NULL;
+    statement->label_length = record->label_length;
+    statement->token = (record->token_offset >= 0) ? line + record->token_offset : NULL;
+    statement->token_length = record->token_length;
+    statement->rest = (record->rest_offset >= 0) ? line + record->rest_offset : NULL;
+}
@@ -1 +1,97 @@
- 
\ No newline at end of file
+#ifndef ASSEMBLER_PARSER_H
+#define ASSEMBLER_PARSER_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes global constants like MAX_LINE_LENGTH */
+#include "utils.h"       /* Includes general utility functions like get_opcode_value */
+
+/**
+ * @brief This header file declares the syntactic analysis functions of the assembler.
+ * Its purpose is to interpret the type of each source statement (empty, comment,
+ * macro definition start/end, directive, instruction, or a bare identifier such as
+ * a macro call) in a single scan of the line, and to expose the positions of the
+ * label and the first tokens so that later stages do not need to rescan the line.
+ */
+
+/* --- Statement Type Definitions --- */
+
+/**
+ * @brief Enumeration of the kinds of statements a source line can hold.
+ */
+typedef enum {
+    STATEMENT_EMPTY = 0,        /* Blank line, or a line holding only whitespace */
+    STATEMENT_COMMENT,          /* Line whose first non-whitespace character is ';' */
+    STATEMENT_MACRO_START,      /* 'mcro' keyword */
+    STATEMENT_MACRO_END,        /* 'mcroend' keyword */
+    STATEMENT_DIRECTIVE,        /* A token starting with '.' (e.g. .data, .entry) */
+    STATEMENT_INSTRUCTION,      /* A known operation name (mov, add, ..., stop) */
+    STATEMENT_IDENTIFIER,       /* Any other identifier, e.g. a macro call or an unknown operation */
+    STATEMENT_INVALID           /* A token that cannot start any statement, or a label without a statement */
+} StatementKind;
+
+/**
+ * @brief The result of classifying a source line.
+ * All pointers refer into the classified line; lengths exclude any terminator.
+ */
+typedef struct {
+    StatementKind kind;         /* Kind of the statement following the optional label */
+    const char* label;          /* Label definition ("LABEL:"), or NULL if none */
+    int label_length;           /* Length of the label, without the ':' */
+    const char* token;          /* First token of the statement (keyword, directive or identifier) */
+    int token_length;           /* Length of the first token */
+    const char* rest;           /* First non-whitespace character after the first token */
+    int opcode;                 /* Opcode value when kind is STATEMENT_INSTRUCTION, -1 otherwise */
+} Statement;
+
+/**
+ * @brief A classified line stored independently of the buffer it was classified in.
+ * Positions are offsets from the start of the line (-1 when absent), so a block of
+ * text (e.g. a macro body) can be classified once, kept with its records, and each
+ * record turned back into a Statement for the line without scanning it again.
+ */
+typedef struct {
+    StatementKind kind;         /* Kind of the statement */
+    int opcode;                 /* Opcode value when kind is STATEMENT_INSTRUCTION, -1 otherwise */
+    int line_offset;            /* Offset of the line in its block of text */
+    int line_length;            /* Length of the line, including its newline */
+    int label_offset;           /* Offset of the label in the line, or -1 if none */
+    int label_length;           /* Length of the label, without the ':' */
+    int token_offset;           /* Offset of the first token in the line, or -1 if none */
+    int token_length;           /* Length of the first token */
+    int rest_offset;            /* Offset of the rest of the statement in the line, or -1 if none */
+    int source_line;            /* Line number of the line in the file that defined it */
+} LineRecord;
+
+/* --- Statement Classification Functions --- */
+
+/**
+ * @brief Classifies a source line in a single left-to-right scan.
+ * The first non-whitespace character selects a handler through a dispatch table;
+ * identifier handlers then use the token length to select the few keywords it
+ * can match. A label definition ("LABEL:") is recorded and the statement after it
+ * is classified the same way.
+ * @param line The line to classify (null-terminated, may include the newline).
+ * @param statement A pointer to the structure that receives the classification.
+ * @return The kind of the statement (also stored in statement->kind).
+ */
+StatementKind classify_statement(const char* line, Statement* statement);
+
+/**
+ * @brief Stores the classification of a line as buffer-independent offsets.
+ * Only the classification fields of the record are set; the caller fills in
+ * line_offset, line_length and source_line.
+ * @param statement The classification, as returned by classify_statement.
+ * @param line The line that was classified.
+ * @param record A pointer to the record that receives the classification.
+ */
+void record_statement(const Statement* statement, const char* line, LineRecord* record);
+
+/**
+ * @brief Rebuilds the classification of a recorded line for a copy of its text.
+ * @param record The record of the line.
+ * @param line The start of the line (any copy of the recorded text).
+ * @param statement A pointer to the structure that receives the classification.
+ */
+void restore_statement(const LineRecord* record, const char* line, Statement* statement);
+
+#endif /* ASSEMBLER_PARSER_H */
@@ -0,0 +1,118 @@
+#ifdef __linux__
+#define _GNU_SOURCE  /* For syscall and clock_gettime under -std=c99 */
+#endif
+
+#include "perf_counters.h"
+#include "definitions.h"
+
+#include <string.h>  /* For memset */
+#include <time.h>    /* For clock, clock_gettime */
+
+#ifdef __linux__
+#include <unistd.h>              /* For syscall, read, close */
+#include <sys/ioctl.h>           /* For ioctl */
+#include <sys/syscall.h>         /* For __NR_perf_event_open */
+#include <linux/perf_event.h>    /* For struct perf_event_attr */
+#endif
+
+/* Display names, in HardwareCounter order */
+static const char* counter_names[NUM_HARDWARE_COUNTERS] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"
+};
+
+#ifdef __linux__
+
+/* File descriptors of the open counters (-1 = not open) */
+static int g_counter_fds[NUM_HARDWARE_COUNTERS] = { -1, -1, -1, -1, -1 };
+
+/**
+ * @brief Opens one counter for the calling thread, user space only
+ * @param type The perf event type
+ * @param config The perf event configuration
+ * @return The file descriptor, or -1 if the counter could not be opened
+ */
+static int open_counter(unsigned int type, __u64 config) {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+double read_wall_clock_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+int open_hardware_counters() {
+    int any_open = FALSE;
+    int i;
+
+    close_hardware_counters();
+    g_counter_fds[COUNTER_CYCLES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    g_counter_fds[COUNTER_INSTRUCTIONS] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    g_counter_fds[COUNTER_BRANCH_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    g_counter_fds[COUNTER_L1D_MISSES] = open_counter(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    g_counter_fds[COUNTER_LLC_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+        if (g_counter_fds[i] >= 0) {
+            ioctl(g_counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(g_counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            any_open = TRUE;
+        }
+    }
+    return any_open;
+}
+
+void read_hardware_counters(CounterSample* sample) {
+    int i;
+    for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+        __u64 value = 0;  /* The kernel always reports 64 bits */
+        sample->available[i] = g_counter_fds[i] >= 0 &&
+                               read(g_counter_fds[i], &value, sizeof(value)) == (ssize_t)sizeof(value);
+        sample->values[i] = sample->available[i] ? (unsigned long)value : 0;
+    }
+}
+
+void close_hardware_counters() {
+    int i;
+    for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+        if (g_counter_fds[i] >= 0) {
+            close(g_counter_fds[i]);
+            g_counter_fds[i] = -1;
+        }
+    }
+}
+
+#else /* Not Linux: time only */
+
+double read_wall_clock_seconds() {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+int open_hardware_counters() {
+    return FALSE;
+}
+
+void read_hardware_counters(CounterSample* sample) {
+    memset(sample, 0, sizeof(*sample));
+}
+
+void close_hardware_counters() {
+}
+
+#endif /* __linux__ */
+
+const char* hardware_counter_name(HardwareCounter counter) {
+    if (counter < 0 || counter >= NUM_HARDWARE_COUNTERS) {
+        return "unknown";
+    }
+    return counter_names[counter];
+}
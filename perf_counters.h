@@ -0,0 +1,70 @@
+#ifndef ASSEMBLER_PERF_COUNTERS_H
+#define ASSEMBLER_PERF_COUNTERS_H
+
+/**
+ * @brief This header file declares access to a monotonic clock and to the CPU's
+ * hardware performance counters, used by the --stats mode and the benchmarks.
+ * On Linux the counters (cycles, instructions, branch misses, L1 data cache and
+ * last-level cache misses) are read through perf_event_open for the calling
+ * thread, user space only. On other systems, or when the kernel refuses access,
+ * the counters are reported as unavailable and only time is measured.
+ */
+
+/* --- Hardware Counter Definitions --- */
+
+/**
+ * @brief The hardware events that are counted.
+ */
+typedef enum {
+    COUNTER_CYCLES = 0,         /* CPU cycles */
+    COUNTER_INSTRUCTIONS,       /* Retired instructions */
+    COUNTER_BRANCH_MISSES,      /* Mispredicted branches */
+    COUNTER_L1D_MISSES,         /* L1 data cache read misses */
+    COUNTER_LLC_MISSES,         /* Last-level cache misses */
+    NUM_HARDWARE_COUNTERS
+} HardwareCounter;
+
+/**
+ * @brief A snapshot of all hardware counters.
+ * A counter that could not be opened keeps the value 0 and is flagged in `available`.
+ * Values are unsigned long, which is 64 bits on the LP64 systems that have counters.
+ */
+typedef struct {
+    unsigned long values[NUM_HARDWARE_COUNTERS];    /* Counter values */
+    int available[NUM_HARDWARE_COUNTERS];           /* TRUE if the counter is being read */
+} CounterSample;
+
+/* --- Clock and Counter Functions --- */
+
+/**
+ * @brief Returns the current time of a monotonic wall clock, in seconds.
+ * Falls back to processor time where no monotonic clock is available.
+ * @return The current time in seconds, relative to an unspecified starting point.
+ */
+double read_wall_clock_seconds();
+
+/**
+ * @brief Opens and starts the hardware counters for the calling thread.
+ * @return TRUE if at least one counter is available, FALSE otherwise.
+ */
+int open_hardware_counters();
+
+/**
+ * @brief Reads the current value of every open hardware counter.
+ * @param sample The snapshot to fill.
+ */
+void read_hardware_counters(CounterSample* sample);
+
+/**
+ * @brief Stops and closes all hardware counters.
+ */
+void close_hardware_counters();
+
+/**
+ * @brief Returns a short display name for a counter.
+ * @param counter The counter.
+ * @return The name (e.g. "cycles").
+ */
+const char* hardware_counter_name(HardwareCounter counter);
+
+#endif /* ASSEMBLER_PERF_COUNTERS_H */
@@ -1,6 +1,13 @@
 #include "pre_assembler.h"
 #include "error_handler.h"
 #include "utils.h"
+#include "symbol_table.h"
+#include "parser.h"
+#include "manifest.h"
+#include "macro_library.h"
+#include "statistics.h"
+#include "source_buffer.h"
+#include "packfile.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -8,30 +15,143 @@
 
 /* --- Macro Structure Definition --- */
 
+/**
+ * @brief Progress of resolving the macro calls inside a macro's body
+ */
+typedef enum {
+    EXPANSION_PENDING = 0,  /* Not resolved yet */
+    EXPANSION_ACTIVE,       /* Being resolved; reaching it again means a recursive call */
+    EXPANSION_DONE          /* Calls resolved and expanded_length known */
+} ExpansionState;
+
+/* Call targets of body lines that do not call a macro of the file */
+#define TARGET_NONE (-1)        /* Not a macro call */
+#define TARGET_LIBRARY (-2)     /* A call to a library macro */
+
 /**
  * @brief Structure to represent a macro definition
  */
 typedef struct {
-    char name[MAX_LABEL_LENGTH];  /* Macro name */
+    char name[MAX_LABEL_LENGTH + 1];  /* Macro name */
+    int name_id;                      /* Interned identifier id of the name */
+    const char* file_name;            /* Base name of the file that defines it, for error messages */
     char* body;                       /* Macro body content */
     int body_length;                  /* Length of macro body */
+    LineRecord* lines;                /* Body lines, classified once when the definition ends */
+    int line_count;                   /* Number of body lines */
+    ExpansionState expansion_state;   /* Progress of resolving the calls in the body */
+    int* line_targets;                /* Per body line: index of the called macro, or TARGET_* */
+    int calls_macros;                 /* TRUE if any body line is a macro call */
+    long expanded_length;             /* Length of the body with every call expanded */
 } Macro;
 
+/**
+ * @brief Values of a binary file named by a '.incbin' line, loaded during macro collection
+ */
+typedef struct {
+    int* values;                      /* The values, each in the range of a data word */
+    int count;                        /* Number of values */
+} BinaryInclude;
+
+/**
+ * @brief One macro being resolved or expanded on the expansion work stack
+ */
+typedef struct {
+    Macro* macro;                     /* The macro */
+    int line;                         /* Index of its next body line */
+    long label_length;                /* Length of the label of the current call line */
+} ExpansionFrame;
+
+/**
+ * @brief Destination of an expansion: a tracked output file, or a preallocated buffer
+ */
+typedef struct {
+    TrackedFile* file;                /* Output file, or NULL to write into buffer */
+    char* buffer;                     /* Buffer of at least expanded_length + 1 bytes */
+    long length;                      /* Number of bytes written into buffer */
+} ExpansionSink;
+
 /* --- Global Variables for Macro Management --- */
 
 static Macro* g_macros = NULL;        /* Array of defined macros */
 static int g_macro_count = 0;         /* Number of defined macros */
 static int g_macro_capacity = 0;      /* Capacity of macros array */
+static int* g_macro_by_id = NULL;     /* Per interned identifier id: index of its macro, or -1 */
+static int g_macro_by_id_size = 0;    /* Number of entries in g_macro_by_id */
+static int g_check_only = FALSE;      /* Validate only: no expansion, no output */
+static ExpansionFrame* g_frames = NULL;  /* Work stack of resolve_macro_calls and emit_macro */
+static int g_frame_capacity = 0;         /* Capacity of the work stack */
+
+/* --- Global Variables for Binary Includes --- */
+
+static BinaryInclude* g_includes = NULL;  /* '.incbin' values, in source order */
+static int g_include_count = 0;           /* Number of loaded includes */
+static int g_include_capacity = 0;        /* Capacity of includes array */
 
 /* --- Internal Helper Functions --- */
 
+/**
+ * @brief Classifies every line of a macro body once, into line records
+ * Call sites then reuse the records instead of scanning the body text again.
+ * @param macro The macro whose body is classified
+ * @param first_line The source line number of the first body line
+ */
+static void parse_macro_body(Macro* macro, int first_line) {
+    char line[MAX_LINE_LENGTH + 2];  /* Classification needs at most one line's worth of text */
+    Statement statement;
+    const char* newline;
+    int offset = 0;
+    int count = 0;
+    int i;
+    
+    /* Count the lines: every newline ends one, and a final unterminated piece is one more */
+    for (i = 0; i < macro->body_length; i++) {
+        if (macro->body[i] == '\n') {
+            count++;
+        }
+    }
+    if (macro->body_length > 0 && macro->body[macro->body_length - 1] != '\n') {
+        count++;
+    }
+    
+    macro->lines = (LineRecord*)malloc((count > 0 ? count : 1) * sizeof(LineRecord));
+    macro->line_count = 0;
+    if (macro->lines == NULL) {
+        return;
+    }
+    
+    while (offset < macro->body_length) {
+        LineRecord* record = &macro->lines[macro->line_count];
+        int length;
+        int copy_length;
+        
+        newline = (const char*)memchr(macro->body + offset, '\n', macro->body_length - offset);
+        length = (newline != NULL) ? (int)(newline - (macro->body + offset)) + 1 : macro->body_length - offset;
+        
+        /* Classify a null-terminated copy, so the scan cannot run into the next line */
+        copy_length = (length < (int)sizeof(line) - 1) ? length : (int)sizeof(line) - 1;
+        memcpy(line, macro->body + offset, copy_length);
+        line[copy_length] = '\0';
+        classify_statement(line, &statement);
+        record_statement(&statement, line, record);
+        
+        record->line_offset = offset;
+        record->line_length = length;
+        record->source_line = first_line + macro->line_count;
+        macro->line_count++;
+        offset += length;
+    }
+}
+
 /**
  * @brief Adds a new macro to the global macros array
- * @param name The name of the macro
+ * @param name_id The interned identifier id of the macro name
  * @param body The body content of the macro
  * @param body_length The length of the macro body
+ * @param first_line The source line number of the first body line
+ * @param file_name The base name of the file that defines the macro (must outlive the macro)
  */
-static void add_macro(const char* name, const char* body, int body_length) {
+static void add_macro(int name_id, const char* body, int body_length, int first_line, const char* file_name) {
     /* Expand array if needed */
     if (g_macro_count >= g_macro_capacity) {
         int new_capacity = (g_macro_capacity == 0) ? 10 : g_macro_capacity * 2;
@@ -40,9 +160,31 @@ static void add_macro(const char* name, const char* body, int body_length) {
         g_macro_capacity = new_capacity;
     }
     
+    /* Map the name's id to the new macro, so lookups are a single index */
+    if (name_id >= g_macro_by_id_size) {
+        int new_size = (g_macro_by_id_size == 0) ? 64 : g_macro_by_id_size;
+        int* new_map;
+        int i;
+        while (new_size <= name_id) {
+            new_size *= 2;
+        }
+        new_map = (int*)realloc(g_macro_by_id, new_size * sizeof(int));
+        if (new_map == NULL) {
+            return;
+        }
+        for (i = g_macro_by_id_size; i < new_size; i++) {
+            new_map[i] = -1;
+        }
+        g_macro_by_id = new_map;
+        g_macro_by_id_size = new_size;
+    }
+    g_macro_by_id[name_id] = g_macro_count;
+    
     /* Copy macro name */
-    strncpy(g_macros[g_macro_count].name, name, MAX_LABEL_LENGTH);
+    strncpy(g_macros[g_macro_count].name, get_identifier_name(name_id), MAX_LABEL_LENGTH);
     g_macros[g_macro_count].name[MAX_LABEL_LENGTH] = '\0';
+    g_macros[g_macro_count].name_id = name_id;
+    g_macros[g_macro_count].file_name = file_name;
     
     /* Allocate and copy macro body */
     g_macros[g_macro_count].body = (char*)malloc(body_length + 1);
@@ -50,33 +192,64 @@ static void add_macro(const char* name, const char* body, int body_length) {
     g_macros[g_macro_count].body[body_length] = '\0';
     g_macros[g_macro_count].body_length = body_length;
     
+    /* Parse the body once; every call site reuses the records */
+    parse_macro_body(&g_macros[g_macro_count], first_line);
+    g_macros[g_macro_count].expansion_state = EXPANSION_PENDING;
+    g_macros[g_macro_count].line_targets = NULL;
+    g_macros[g_macro_count].calls_macros = FALSE;
+    g_macros[g_macro_count].expanded_length = body_length;
+    
     g_macro_count++;
 }
 
 /**
- * @brief Finds a macro by name
- * @param name The name of the macro to find
+ * @brief Finds a macro by the interned id of its name
+ * @param name_id The identifier id of the macro name to find
  * @return Pointer to the macro if found, NULL otherwise
  */
-static Macro* find_macro(const char* name) {
+static Macro* find_macro(int name_id) {
+    if (name_id < 0 || name_id >= g_macro_by_id_size || g_macro_by_id[name_id] < 0) {
+        return NULL;
+    }
+    return &g_macros[g_macro_by_id[name_id]];
+}
+
+/**
+ * @brief Frees the line records and call targets of a macro (not its body)
+ * @param macro The macro
+ */
+static void free_macro_lines(Macro* macro) {
+    free(macro->lines);
+    free(macro->line_targets);
+    macro->lines = NULL;
+    macro->line_targets = NULL;
+}
+
+/**
+ * @brief Frees the values loaded for '.incbin' lines
+ */
+static void free_binary_includes() {
     int i;
-    for (i = 0; i < g_macro_count; i++) {
-        if (strcmp(g_macros[i].name, name) == 0) {
-            return &g_macros[i];
-        }
+    for (i = 0; i < g_include_count; i++) {
+        free(g_includes[i].values);
     }
-    return NULL;
+    free(g_includes);
+    g_includes = NULL;
+    g_include_count = 0;
+    g_include_capacity = 0;
 }
 
 /**
- * @brief Frees all allocated macro memory
+ * @brief Frees all allocated macro memory, and the values of binary includes
  */
 static void free_macros() {
     int i;
+    free_binary_includes();
     for (i = 0; i < g_macro_count; i++) {
         if (g_macros[i].body != NULL) {
             free(g_macros[i].body);
         }
+        free_macro_lines(&g_macros[i]);
     }
     if (g_macros != NULL) {
         free(g_macros);
@@ -84,52 +257,12 @@ static void free_macros() {
     g_macros = NULL;
     g_macro_count = 0;
     g_macro_capacity = 0;
-}
-
-/**
- * @brief Validates macro name according to the rules
- * @param name The macro name to validate
- * @return TRUE if valid, FALSE otherwise
- */
-static int is_valid_macro_name(const char* name) {
-    int len;
-    const char* original_name = name;
-    
-    /* Check if name is NULL or empty */
-    if (name == NULL || *name == '\0') {
-        return FALSE;
-    }
-    
-    /* Check length */
-    len = strlen(name);
-    if (len > MAX_LABEL_LENGTH) {
-        return FALSE;
-    }
-    
-    /* Check if starts with underscore */
-    if (name[0] == '_') {
-        return FALSE;
-    }
-    
-    /* Check if starts with letter */
-    if (!is_alpha(name[0])) {
-        return FALSE;
-    }
-    
-    /* Check all characters are valid */
-    while (*name != '\0') {
-        if (!is_alphanumeric(*name)) {
-            return FALSE;
-        }
-        name++;
-    }
-    
-    /* Check if it's a reserved keyword */
-    if (is_reserved_keyword(original_name)) {
-        return FALSE;
-    }
-    
-    return TRUE;
+    free(g_macro_by_id);
+    g_macro_by_id = NULL;
+    g_macro_by_id_size = 0;
+    free(g_frames);
+    g_frames = NULL;
+    g_frame_capacity = 0;
 }
 
 /**
@@ -152,8 +285,8 @@ static int extract_macro_name(const char* line, char* macro_name, unsigned int b
     /* Trim whitespace */
     trimmed_line = trim_whitespace(line_copy);
     
-    /* Skip "mcro" keyword */
-    if (strncmp(trimmed_line, "mcro", 4) != 0) {
+    /* Skip "mcro" keyword (which must be a whole word, not the start of "mcroend") */
+    if (strncmp(trimmed_line, "mcro", 4) != 0 || !is_whitespace(trimmed_line[4])) {
         return FALSE;
     }
     
@@ -196,51 +329,545 @@ static int extract_macro_name(const char* line, char* macro_name, unsigned int b
 }
 
 /**
- * @brief Checks if a line is a macro call
- * @param line The line to check
- * @return Name of macro if it's a call, NULL otherwise
+ * @brief Finds the macro of this file called by a classified statement
+ * @param statement The classification of the line
+ * @return The called macro, or NULL if the line does not call a macro of this file
  */
-static const char* is_macro_call(const char* line) {
-    char* trimmed_line;
-    char line_copy[MAX_LINE_LENGTH + 1];
-    char macro_name[MAX_LABEL_LENGTH + 1];
-    char* token;
+static Macro* find_called_file_macro(const Statement* statement) {
+    if (statement->kind != STATEMENT_IDENTIFIER || statement->token_length > MAX_LABEL_LENGTH) {
+        return NULL;
+    }
     
-    /* Copy line to avoid modifying original */
-    strncpy(line_copy, line, MAX_LINE_LENGTH);
-    line_copy[MAX_LINE_LENGTH] = '\0';
+    /* A name that was never interned cannot be a macro of this file */
+    return find_macro(find_identifier_span(statement->token, statement->token_length));
+}
+
+/**
+ * @brief Finds the library macro called by a classified statement
+ * @param statement The classification of the line
+ * @return The body of the called library macro, or NULL if the line does not call one
+ */
+static const char* find_called_library_body(const Statement* statement) {
+    if (statement->kind != STATEMENT_IDENTIFIER || statement->token_length > MAX_LABEL_LENGTH) {
+        return NULL;
+    }
+    return find_library_macro(statement->token, statement->token_length);
+}
+
+/**
+ * @brief Makes room for one more frame on the expansion work stack
+ * @param depth The number of frames in use
+ * @return TRUE on success, FALSE if memory allocation failed
+ */
+static int reserve_frame(int depth) {
+    if (depth >= g_frame_capacity) {
+        int new_capacity = (g_frame_capacity == 0) ? 64 : g_frame_capacity * 2;
+        ExpansionFrame* new_frames = (ExpansionFrame*)realloc(g_frames, new_capacity * sizeof(ExpansionFrame));
+        if (new_frames == NULL) {
+            return FALSE;
+        }
+        g_frames = new_frames;
+        g_frame_capacity = new_capacity;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Starts resolving a macro: marks it active and allocates its call targets
+ * @param macro The macro
+ * @return TRUE on success, FALSE if memory allocation failed
+ */
+static int begin_macro_resolution(Macro* macro) {
+    macro->expansion_state = EXPANSION_ACTIVE;
+    macro->expanded_length = 0;
+    macro->line_targets = (int*)malloc((macro->line_count > 0 ? macro->line_count : 1) * sizeof(int));
+    return macro->line_targets != NULL;
+}
+
+/**
+ * @brief Resolves the macro calls inside a macro body and computes its expanded length
+ * Each macro is resolved once; its callers reuse the recorded call targets and length,
+ * so a deep hierarchy is resolved in time linear in the total size of the bodies.
+ * Called macros are resolved on an explicit work stack, not by recursion, so the
+ * depth of the hierarchy is bounded by memory rather than by the C stack.
+ * A call that leads back to a macro still being resolved is reported as
+ * ERROR_RECURSIVE_MACRO_CALL at the body line that makes it, in the file that
+ * defines the calling macro.
+ * @param macro The macro to resolve
+ * @return TRUE on success, FALSE if a recursive call was found
+ */
+static int resolve_macro_calls(Macro* macro) {
+    int success = TRUE;
+    int depth = 0;
     
-    /* Trim whitespace */
-    trimmed_line = trim_whitespace(line_copy);
+    if (macro->expansion_state == EXPANSION_DONE) {
+        return TRUE;
+    }
+    if (!reserve_frame(depth) || !begin_macro_resolution(macro)) {
+        report_error(macro->file_name, 0, ERROR_INTERNAL_ERROR);
+        macro->expansion_state = EXPANSION_DONE;
+        return FALSE;
+    }
+    g_frames[depth].macro = macro;
+    g_frames[depth].line = 0;
+    depth++;
     
-    /* Skip label if present */
-    if (strchr(trimmed_line, ':') != NULL) {
-        trimmed_line = strchr(trimmed_line, ':') + 1;
-        trimmed_line = skip_whitespace(trimmed_line);
+    while (depth > 0) {
+        ExpansionFrame* frame = &g_frames[depth - 1];
+        Macro* current = frame->macro;
+        const LineRecord* record;
+        const char* line;
+        const char* library_body;
+        Statement statement;
+        Macro* called;
+        
+        /* A finished macro adds its expansion to the call in its caller */
+        if (frame->line >= current->line_count) {
+            current->expansion_state = EXPANSION_DONE;
+            depth--;
+            if (depth > 0) {
+                frame = &g_frames[depth - 1];
+                frame->macro->line_targets[frame->line] = (int)(current - g_macros);
+                frame->macro->expanded_length += frame->label_length + current->expanded_length;
+                frame->macro->calls_macros = TRUE;
+                frame->line++;
+            }
+            continue;
+        }
+        
+        record = &current->lines[frame->line];
+        line = current->body + record->line_offset;
+        current->line_targets[frame->line] = TARGET_NONE;
+        restore_statement(record, line, &statement);
+        frame->label_length = (statement.label != NULL) ? (long)(statement.label - line) + statement.label_length + 1 : 0;
+        
+        called = find_called_file_macro(&statement);
+        if (called != NULL) {
+            if (called->expansion_state == EXPANSION_ACTIVE) {
+                report_error(current->file_name, record->source_line, ERROR_RECURSIVE_MACRO_CALL);
+                success = FALSE;
+                frame->line++;
+            } else if (called->expansion_state == EXPANSION_DONE) {
+                current->line_targets[frame->line] = (int)(called - g_macros);
+                current->expanded_length += frame->label_length + called->expanded_length;
+                current->calls_macros = TRUE;
+                frame->line++;
+            } else {
+                /* Resolve the called macro first; its frame completes this line */
+                if (!reserve_frame(depth) || !begin_macro_resolution(called)) {
+                    report_error(called->file_name, 0, ERROR_INTERNAL_ERROR);
+                    called->expansion_state = EXPANSION_DONE;
+                    success = FALSE;
+                    g_frames[depth - 1].line++;  /* The stack may have moved */
+                    continue;
+                }
+                g_frames[depth].macro = called;
+                g_frames[depth].line = 0;
+                depth++;
+            }
+            continue;
+        }
+        
+        library_body = find_called_library_body(&statement);
+        if (library_body != NULL) {
+            current->line_targets[frame->line] = TARGET_LIBRARY;
+            current->expanded_length += frame->label_length + (long)strlen(library_body);
+            current->calls_macros = TRUE;
+        } else {
+            current->expanded_length += record->line_length;
+        }
+        frame->line++;
     }
     
-    /* Extract first token */
-    token = trimmed_line;
-    while (*token != '\0' && !is_whitespace(*token)) {
-        token++;
+    return success;
+}
+
+/**
+ * @brief Resolves the calls inside every macro of the file, reporting recursive calls
+ * This runs at the end of macro collection, so recursion is found even in
+ * macros that are never called, and in check mode.
+ * @return TRUE if errors were found, FALSE otherwise
+ */
+static int resolve_all_macro_calls() {
+    int has_errors_in_file = FALSE;
+    int i;
+    for (i = 0; i < g_macro_count; i++) {
+        if (!resolve_macro_calls(&g_macros[i])) {
+            has_errors_in_file = TRUE;
+        }
+    }
+    return has_errors_in_file;
+}
+
+/**
+ * @brief Writes text to an expansion sink
+ * @param sink The sink
+ * @param text The text to write
+ * @param length The number of bytes to write
+ */
+static void emit_text(ExpansionSink* sink, const char* text, long length) {
+    if (sink->file != NULL) {
+        tracked_write(text, (unsigned long)length, sink->file);
+    } else {
+        memcpy(sink->buffer + sink->length, text, length);
+        sink->length += length;
     }
+}
+
+/**
+ * @brief Writes the expansion of a resolved macro: its body with every call expanded
+ * The output is produced directly from the bodies, in time linear in its size;
+ * a body without calls is written in one piece. Nested calls are followed on
+ * the explicit work stack, as in resolve_macro_calls.
+ * @param macro The macro (resolved by resolve_macro_calls)
+ * @param sink The destination
+ * @return TRUE on success, FALSE if memory allocation failed
+ */
+static int emit_macro(const Macro* macro, ExpansionSink* sink) {
+    int depth = 0;
     
-    /* Copy token */
-    if (token == trimmed_line) {
-        return NULL;
+    if (!macro->calls_macros) {
+        emit_text(sink, macro->body, macro->body_length);
+        return TRUE;
+    }
+    if (!reserve_frame(depth)) {
+        return FALSE;
     }
+    g_frames[depth].macro = (Macro*)macro;
+    g_frames[depth].line = 0;
+    depth++;
     
-    if ((unsigned int)(token - trimmed_line) > MAX_LABEL_LENGTH) {
-        return NULL;
+    while (depth > 0) {
+        ExpansionFrame* frame = &g_frames[depth - 1];
+        const Macro* current = frame->macro;
+        const LineRecord* record;
+        const char* line;
+        const Macro* called;
+        Statement statement;
+        int target;
+        
+        if (frame->line >= current->line_count) {
+            depth--;
+            continue;
+        }
+        record = &current->lines[frame->line];
+        line = current->body + record->line_offset;
+        target = current->line_targets[frame->line];
+        frame->line++;
+        
+        if (target == TARGET_NONE) {
+            emit_text(sink, line, record->line_length);
+            continue;
+        }
+        
+        /* Keep the label, up to and including the ':', as at a top-level call */
+        restore_statement(record, line, &statement);
+        if (statement.label != NULL) {
+            emit_text(sink, line, (long)(statement.label - line) + statement.label_length + 1);
+        }
+        if (target == TARGET_LIBRARY) {
+            const char* library_body = find_called_library_body(&statement);
+            emit_text(sink, library_body, (long)strlen(library_body));
+            continue;
+        }
+        called = &g_macros[target];
+        if (!called->calls_macros) {
+            emit_text(sink, called->body, called->body_length);
+            continue;
+        }
+        if (!reserve_frame(depth)) {
+            return FALSE;
+        }
+        g_frames[depth].macro = (Macro*)called;
+        g_frames[depth].line = 0;
+        depth++;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Builds the expansion of a resolved macro as a newly allocated string
+ * @param macro The macro (resolved by resolve_macro_calls)
+ * @return The expansion, or NULL if memory allocation failed
+ */
+static char* expand_macro_to_string(const Macro* macro) {
+    ExpansionSink sink;
+    sink.file = NULL;
+    sink.length = 0;
+    sink.buffer = (char*)malloc(macro->expanded_length + 1);
+    if (sink.buffer != NULL && !emit_macro(macro, &sink)) {
+        free(sink.buffer);
+        sink.buffer = NULL;
+    }
+    if (sink.buffer != NULL) {
+        sink.buffer[sink.length] = '\0';
+    }
+    return sink.buffer;
+}
+
+/**
+ * @brief Checks if a classified statement is the '.rept' directive
+ * @param statement The classification of the line
+ * @return TRUE if the line starts a repeat block, FALSE otherwise
+ */
+static int is_repeat_start(const Statement* statement) {
+    return statement->kind == STATEMENT_DIRECTIVE && statement->token_length == 5 &&
+           strncmp(statement->token, ".rept", 5) == 0;
+}
+
+/**
+ * @brief Checks if a classified statement is the '.endr' directive
+ * @param statement The classification of the line
+ * @return TRUE if the line ends a repeat block, FALSE otherwise
+ */
+static int is_repeat_end(const Statement* statement) {
+    return statement->kind == STATEMENT_DIRECTIVE && statement->token_length == 5 &&
+           strncmp(statement->token, ".endr", 5) == 0;
+}
+
+/**
+ * @brief Reads the count of a '.rept' line
+ * @param statement The classification of the line (is_repeat_start must hold)
+ * @return The count, or -1 if the line has a label or the count is missing, extra or out of range
+ */
+static int parse_repeat_count(const Statement* statement) {
+    char* end;
+    long count;
+    
+    if (statement->label != NULL || !isdigit((unsigned char)*statement->rest)) {
+        return -1;
+    }
+    count = strtol(statement->rest, &end, 10);
+    end = skip_whitespace(end);
+    if ((*end != '\0' && *end != ';') || count < 1 || count > MAX_REPEAT_COUNT) {
+        return -1;
+    }
+    return (int)count;
+}
+
+/**
+ * @brief Checks that an '.endr' line has no label and nothing after the directive
+ * @param statement The classification of the line (is_repeat_end must hold)
+ * @return TRUE if the line is well-formed, FALSE otherwise
+ */
+static int is_valid_repeat_end(const Statement* statement) {
+    return statement->label == NULL && (*statement->rest == '\0' || *statement->rest == ';');
+}
+
+/**
+ * @brief Writes a repeat block the requested number of times
+ * The block is treated as an anonymous macro: its lines are classified and its
+ * macro calls resolved once, then every copy is written from those records
+ * (a block without calls is written in one piece per copy).
+ * @param file_name The base name of the file, used in error messages
+ * @param text The lines of the block
+ * @param length The length of the block
+ * @param count The number of copies
+ * @param first_line The source line number of the first line of the block
+ * @param sink The destination
+ */
+static void emit_repeat_block(const char* file_name, char* text, int length, int count,
+                              int first_line, ExpansionSink* sink) {
+    Macro block;
+    int i;
+    
+    memset(&block, 0, sizeof(block));
+    block.name_id = INVALID_IDENTIFIER_ID;
+    block.file_name = file_name;
+    block.body = text;
+    block.body_length = length;
+    parse_macro_body(&block, first_line);
+    if (resolve_macro_calls(&block)) {
+        for (i = 0; i < count; i++) {
+            if (!emit_macro(&block, sink)) {
+                report_error(file_name, first_line, ERROR_INTERNAL_ERROR);
+                break;
+            }
+        }
+    }
+    free_macro_lines(&block);
+}
+
+/**
+ * @brief Checks if a classified statement is the '.incbin' directive
+ * @param statement The classification of the line
+ * @return TRUE if the line includes a binary file, FALSE otherwise
+ */
+static int is_binary_include(const Statement* statement) {
+    return statement->kind == STATEMENT_DIRECTIVE && statement->token_length == 7 &&
+           strncmp(statement->token, ".incbin", 7) == 0;
+}
+
+/**
+ * @brief Reads the operands of a '.incbin' line
+ * A relative path is taken from the directory of the source file.
+ * @param statement The classification of the line (is_binary_include must hold)
+ * @param file_name The base name of the source file
+ * @param path Buffer that receives the path of the binary file
+ * @param path_size The size of the path buffer
+ * @param width Receives the width of each value, in bytes
+ * @return TRUE if the operands are valid, FALSE otherwise
+ */
+static int parse_binary_include(const Statement* statement, const char* file_name,
+                                char* path, int path_size, int* width) {
+    const char* name = statement->rest;
+    const char* name_end;
+    const char* directory_end = strrchr(file_name, '/');
+    int directory_length = 0;
+    char* end;
+    long value;
+    
+    if (*name != '"' || (name_end = strchr(name + 1, '"')) == NULL || name_end == name + 1) {
+        return FALSE;
+    }
+    name++;
+    if (*name != '/' && directory_end != NULL) {
+        directory_length = (int)(directory_end - file_name) + 1;
+    }
+    if (directory_length + (name_end - name) >= path_size) {
+        return FALSE;
+    }
+    memcpy(path, file_name, directory_length);
+    memcpy(path + directory_length, name, name_end - name);
+    path[directory_length + (name_end - name)] = '\0';
+    
+    /* Then ", width" and nothing but a comment */
+    end = skip_whitespace((char*)name_end + 1);
+    if (*end != ',') {
+        return FALSE;
+    }
+    end = skip_whitespace(end + 1);
+    if (!isdigit((unsigned char)*end)) {
+        return FALSE;
+    }
+    value = strtol(end, &end, 10);
+    end = skip_whitespace(end);
+    if ((*end != '\0' && *end != ';') || value < 1 || value > MAX_INCBIN_WIDTH) {
+        return FALSE;
     }
+    *width = (int)value;
+    return TRUE;
+}
+
+/**
+ * @brief Reads the values of a binary file for a '.incbin' line and checks their range
+ * The file is read in one piece (at most one value per memory word) and every
+ * value is checked in a single branch-free pass before any of them is kept.
+ * @param file_name The base name of the source file, used in error messages
+ * @param line_number The line of the '.incbin'
+ * @param path The path of the binary file
+ * @param width The width of each value, in bytes
+ * @return TRUE on success, FALSE if an error was reported
+ */
+static int load_binary_include(const char* file_name, int line_number, const char* path, int width) {
+    unsigned char bytes[MEMORY_SIZE * MAX_INCBIN_WIDTH + 1];  /* One byte more detects a too large file */
+    TrackedFile file;
+    BinaryInclude* include;
+    unsigned long length = 0;
+    unsigned long read_length;
+    int out_of_range = 0;
+    int count;
+    int i;
     
-    strncpy(macro_name, trimmed_line, token - trimmed_line);
-    macro_name[token - trimmed_line] = '\0';
+    if (!tracked_open(&file, path, "rb")) {
+        report_error(file_name, line_number, ERROR_INCBIN_FILE);
+        return FALSE;
+    }
+    do {
+        read_length = tracked_read((char*)bytes + length, sizeof(bytes) - length, &file);
+        length += read_length;
+    } while (read_length > 0 && length < sizeof(bytes));
+    tracked_close(&file, "input", path);
+    
+    if (length == 0 || length > (unsigned long)MEMORY_SIZE * width || length % width != 0) {
+        report_error(file_name, line_number, ERROR_INCBIN_FILE);
+        return FALSE;
+    }
+    count = (int)(length / width);
     
-    /* Check if it's a macro name */
-    {
-        Macro* macro = find_macro(macro_name);
-        return macro ? macro->name : NULL;
+    /* Make room for the include */
+    if (g_include_count >= g_include_capacity) {
+        int new_capacity = (g_include_capacity == 0) ? 8 : g_include_capacity * 2;
+        BinaryInclude* new_includes = (BinaryInclude*)realloc(g_includes, new_capacity * sizeof(BinaryInclude));
+        if (new_includes == NULL) {
+            report_error(file_name, line_number, ERROR_INTERNAL_ERROR);
+            return FALSE;
+        }
+        g_includes = new_includes;
+        g_include_capacity = new_capacity;
+    }
+    include = &g_includes[g_include_count];
+    include->values = (int*)malloc(count * sizeof(int));
+    if (include->values == NULL) {
+        report_error(file_name, line_number, ERROR_INTERNAL_ERROR);
+        return FALSE;
+    }
+    
+    /* Decode signed little-endian values, then check them all at once */
+    if (width == 1) {
+        for (i = 0; i < count; i++) {
+            include->values[i] = (signed char)bytes[i];
+        }
+    } else {
+        for (i = 0; i < count; i++) {
+            include->values[i] = (short)(bytes[2 * i] | (bytes[2 * i + 1] << 8));
+        }
+    }
+    for (i = 0; i < count; i++) {
+        out_of_range |= (include->values[i] < MIN_DATA_WORD_VALUE) | (include->values[i] > MAX_DATA_WORD_VALUE);
+    }
+    if (out_of_range) {
+        free(include->values);
+        report_error(file_name, line_number, ERROR_INCBIN_VALUE_OUT_OF_RANGE);
+        return FALSE;
+    }
+    
+    include->count = count;
+    g_include_count++;
+    return TRUE;
+}
+
+/**
+ * @brief Writes the values of a binary include as '.data' lines
+ * A label on the '.incbin' line is kept on the first of them, which then holds
+ * only as many values as fit within MAX_LINE_LENGTH after the label.
+ * @param include The loaded values
+ * @param statement The classification of the '.incbin' line
+ * @param line The '.incbin' line
+ * @param output The output file
+ */
+static void emit_binary_include(const BinaryInclude* include, const Statement* statement,
+                                const char* line, TrackedFile* output) {
+    char text[MAX_LINE_LENGTH + 2];
+    int values_per_line = INCBIN_VALUES_PER_LINE;
+    int in_line = 0;                 /* Values written on the current line */
+    int length;
+    int i;
+    
+    if (statement->label != NULL) {
+        /* The label, up to and including the ':', and a space */
+        int label_length = (int)(statement->label - line) + statement->label_length + 1;
+        tracked_write(line, (unsigned long)label_length, output);
+        tracked_puts(" ", output);
+        values_per_line = (MAX_LINE_LENGTH - label_length - 1 - INCBIN_LINE_OVERHEAD) / INCBIN_VALUE_TEXT_WIDTH;
+        if (values_per_line > INCBIN_VALUES_PER_LINE) {
+            values_per_line = INCBIN_VALUES_PER_LINE;
+        } else if (values_per_line < 1) {
+            values_per_line = 1;  /* The '.incbin' line itself was longer */
+        }
+    }
+    for (i = 0; i < include->count; i++) {
+        if (in_line == 0) {
+            length = sprintf(text, ".data %d", include->values[i]);
+        } else {
+            length = sprintf(text, ", %d", include->values[i]);
+        }
+        if (++in_line == values_per_line || i == include->count - 1) {
+            text[length++] = '\n';
+            in_line = 0;
+            values_per_line = INCBIN_VALUES_PER_LINE;
+        }
+        tracked_write(text, (unsigned long)length, output);
     }
 }
 
@@ -280,39 +907,29 @@ int is_macro_definition_end(const char* line) {
     return FALSE;
 }
 
-int process_pre_assembly_for_file(const char* file_name) {
-    FILE* input_file = NULL;
-    FILE* output_file = NULL;
-    char input_filename[256];
-    char output_filename[256];
+/**
+ * @brief Reads a source file and collects its macro definitions into the macro table
+ * Macro names are validated and interned; errors are reported with their line numbers.
+ * @param file_name The base name of the file, used in error messages
+ * @param source The source buffer to read, from its current position
+ * @return TRUE if errors were found in the file, FALSE otherwise
+ */
+static int collect_macro_definitions(const char* file_name, SourceBuffer* source) {
     char line[MAX_LINE_LENGTH + 2];  /* +2 for newline and null terminator */
+    Statement statement;             /* Classification of the current line */
     int line_number = 0;
     int in_macro_definition = FALSE;
     char current_macro_name[MAX_LABEL_LENGTH + 1];
+    int current_macro_id = INVALID_IDENTIFIER_ID;
+    int current_macro_line = 0;
+    int in_repeat_block = FALSE;
+    int repeat_line = 0;
     char* macro_body = NULL;
     int macro_body_size = 0;
     int macro_body_capacity = 0;
     int has_errors_in_file = FALSE;
     
-    /* Reset error flag */
-    reset_error_flag();
-    
-    /* Free any existing macros */
-    free_macros();
-    
-    /* Construct filenames */
-    sprintf(input_filename, "%s%s", file_name, AS_EXTENSION);
-    sprintf(output_filename, "%s%s", file_name, AM_EXTENSION);
-    
-    /* Open input file */
-    input_file = fopen(input_filename, "r");
-    if (input_file == NULL) {
-        report_error(file_name, 0, ERROR_FILE_OPEN_FAILED);
-        return FALSE;
-    }
-    
-    /* First pass: collect macro definitions */
-    while (fgets(line, sizeof(line), input_file) != NULL) {
+    while (source_gets(line, sizeof(line), source) != NULL) {
         line_number++;
         
         /* Check line length */
@@ -322,36 +939,83 @@ int process_pre_assembly_for_file(const char* file_name) {
             continue;
         }
         
-        /* Check for macro definition start */
-        if (is_macro_definition_start(line, current_macro_name, sizeof(current_macro_name))) {
-            /* Validate macro name */
-            if (!is_valid_macro_name(current_macro_name)) {
-                if (is_reserved_keyword(current_macro_name)) {
-                    report_error(file_name, line_number, ERROR_MACRO_NAME_RESERVED_KEYWORD);
-                } else {
-                    report_error(file_name, line_number, ERROR_MACRO_NAME_INVALID_FORMAT);
+        /* Classify the line once; only keyword lines are examined further */
+        classify_statement(line, &statement);
+        
+        /* Validate repeat blocks; they are replicated during expansion */
+        if (is_repeat_start(&statement) || is_repeat_end(&statement)) {
+            if (in_macro_definition) {
+                report_error(file_name, line_number, ERROR_REPEAT_BLOCK_SYNTAX);
+                has_errors_in_file = TRUE;
+            } else if (is_repeat_start(&statement)) {
+                if (in_repeat_block || parse_repeat_count(&statement) < 0) {
+                    report_error(file_name, line_number, ERROR_REPEAT_BLOCK_SYNTAX);
+                    has_errors_in_file = TRUE;
+                }
+                in_repeat_block = TRUE;
+                repeat_line = line_number;
+            } else {
+                if (!in_repeat_block || !is_valid_repeat_end(&statement)) {
+                    report_error(file_name, line_number, ERROR_REPEAT_BLOCK_SYNTAX);
+                    has_errors_in_file = TRUE;
                 }
+                in_repeat_block = FALSE;
+            }
+            continue;
+        }
+        
+        /* Check for macro definition start */
+        if (statement.kind == STATEMENT_MACRO_START && statement.label == NULL &&
+            is_macro_definition_start(line, current_macro_name, sizeof(current_macro_name))) {
+            /* A definition cannot start inside another one, or inside a repeat block */
+            if (in_repeat_block) {
+                report_error(file_name, line_number, ERROR_REPEAT_BLOCK_SYNTAX);
+                has_errors_in_file = TRUE;
+                continue;
+            }
+            if (in_macro_definition) {
+                report_error(file_name, line_number, ERROR_NESTED_MACRO_DEFINITION);
                 has_errors_in_file = TRUE;
                 continue;
             }
             
-            /* Check for duplicate macro name */
-            if (find_macro(current_macro_name) != NULL) {
+            /* Validate macro name using its classification from the identifier table */
+            current_macro_id = intern_identifier(current_macro_name);
+            switch (get_identifier_class(current_macro_id)) {
+                case IDENTIFIER_LEGAL:
+                    break;
+                case IDENTIFIER_OPCODE:
+                case IDENTIFIER_DIRECTIVE:
+                case IDENTIFIER_REGISTER:
+                    report_error(file_name, line_number, ERROR_MACRO_NAME_RESERVED_KEYWORD);
+                    has_errors_in_file = TRUE;
+                    continue;
+                default:
+                    report_error(file_name, line_number, ERROR_MACRO_NAME_INVALID_FORMAT);
+                    has_errors_in_file = TRUE;
+                    continue;
+            }
+            
+            /* Check for duplicate macro name, in the file or in the loaded library */
+            if (find_macro(current_macro_id) != NULL ||
+                find_library_macro(current_macro_name, (int)strlen(current_macro_name)) != NULL) {
                 report_error(file_name, line_number, ERROR_LABEL_REDEFINITION);
                 has_errors_in_file = TRUE;
                 continue;
             }
             
             in_macro_definition = TRUE;
+            current_macro_line = line_number;
             macro_body_size = 0;
             continue;
         }
         
         /* Check for macro definition end */
-        if (is_macro_definition_end(line)) {
+        if (statement.kind == STATEMENT_MACRO_END && statement.label == NULL &&
+            is_macro_definition_end(line)) {
             /* Add macro to collection */
             if (macro_body_size > 0) {
-                add_macro(current_macro_name, macro_body, macro_body_size);
+                add_macro(current_macro_id, macro_body, macro_body_size, current_macro_line + 1, file_name);
             }
             
             in_macro_definition = FALSE;
@@ -364,6 +1028,21 @@ int process_pre_assembly_for_file(const char* file_name) {
             continue;
         }
         
+        /* Binary includes are loaded now, so their errors are found before any output */
+        if (is_binary_include(&statement)) {
+            char include_path[256];
+            int width;
+            
+            if (in_macro_definition || in_repeat_block ||
+                !parse_binary_include(&statement, file_name, include_path, sizeof(include_path), &width)) {
+                report_error(file_name, line_number, ERROR_INCBIN_SYNTAX);
+                has_errors_in_file = TRUE;
+            } else if (!load_binary_include(file_name, line_number, include_path, width)) {
+                has_errors_in_file = TRUE;
+            }
+            continue;
+        }
+        
         /* If in macro definition, collect body */
         if (in_macro_definition) {
             int line_len = strlen(line);
@@ -381,49 +1060,99 @@ int process_pre_assembly_for_file(const char* file_name) {
             macro_body_size += line_len;
         }
     }
+    
+    /* A repeat block must be closed before the end of the file */
+    if (in_repeat_block) {
+        report_error(file_name, repeat_line, ERROR_UNCLOSED_REPEAT_BLOCK);
+        has_errors_in_file = TRUE;
+    }
 
     /* Free macro body if still allocated */
     if (macro_body != NULL) {
         free(macro_body);
     }
     
-    /* Close input file */
-    fclose(input_file);
+    return has_errors_in_file;
+}
+
+int process_pre_assembly_for_source(const char* file_name, SourceBuffer* source) {
+    TrackedFile output_file;         /* The .am file, hashed as it is written */
+    ExpansionSink sink;              /* Macro expansions are written to output_file */
+    char output_filename[256];
+    char line[MAX_LINE_LENGTH + 2];  /* +2 for newline and null terminator */
+    Statement statement;             /* Classification of the current line */
+    int line_number = 0;
+    int in_macro_definition = FALSE;
+    char current_macro_name[MAX_LABEL_LENGTH + 1];
+    int has_errors_in_file = FALSE;
+    int in_repeat_block = FALSE;
+    int repeat_count = 0;
+    int repeat_first_line = 0;
+    char* repeat_body = NULL;        /* Lines of the open repeat block */
+    int repeat_body_size = 0;
+    int repeat_body_capacity = 0;
+    int include_index = 0;           /* Next loaded binary include */
+    
+    /* Reset error flag */
+    reset_error_flag();
+    
+    /* Free any existing macros */
+    free_macros();
+    reset_identifier_table();
+    
+    /* Construct output filename */
+    sprintf(output_filename, "%s%s", file_name, AM_EXTENSION);
+    output_file.file = NULL;
+    sink.file = &output_file;
+    sink.buffer = NULL;
+    sink.length = 0;
+    
+    /* First pass: collect macro definitions */
+    begin_stage(STAGE_MACRO_COLLECTION);
+    rewind_source(source);
+    has_errors_in_file = collect_macro_definitions(file_name, source);
+    if (resolve_all_macro_calls()) {
+        has_errors_in_file = TRUE;
+    }
+    end_stage(STAGE_MACRO_COLLECTION);
+    
+    /* In check mode every diagnostic has been reported by now; nothing is written */
+    if (g_check_only) {
+        free_macros();
+        reset_identifier_table();
+        return !has_errors_in_file && !has_errors();
+    }
     
     /* Only create output file if no errors were found */
     if (!has_errors_in_file) {
-        output_file = fopen(output_filename, "w");
-        if (output_file == NULL) {
-            fclose(input_file);
+        if (!open_output_file(&output_file, output_filename)) {
             report_error(file_name, 0, ERROR_FILE_OPEN_FAILED);
             return FALSE;
         }
     }
     
-    /* Second pass: expand macros and write output */
-    input_file = fopen(input_filename, "r");
-    if (input_file == NULL) {
-        if (output_file != NULL) {
-            fclose(output_file);
-        }
-        report_error(file_name, 0, ERROR_FILE_OPEN_FAILED);
-        return FALSE;
-    }
-    
+    /* Second pass: expand macros and write output, from the same buffer */
+    begin_stage(STAGE_MACRO_EXPANSION);
+    rewind_source(source);
     line_number = 0;
     in_macro_definition = FALSE;
     
-    while (fgets(line, sizeof(line), input_file) != NULL) {
+    while (source_gets(line, sizeof(line), source) != NULL) {
         line_number++;
         
+        /* Classify the line once; only keyword lines are examined further */
+        classify_statement(line, &statement);
+        
         /* Check for macro definition start */
-        if (is_macro_definition_start(line, current_macro_name, sizeof(current_macro_name))) {
+        if (statement.kind == STATEMENT_MACRO_START && statement.label == NULL &&
+            is_macro_definition_start(line, current_macro_name, sizeof(current_macro_name))) {
             in_macro_definition = TRUE;
             continue;
         }
         
         /* Check for macro definition end */
-        if (is_macro_definition_end(line)) {
+        if (statement.kind == STATEMENT_MACRO_END && statement.label == NULL &&
+            is_macro_definition_end(line)) {
             in_macro_definition = FALSE;
             continue;
         }
@@ -433,41 +1162,188 @@ int process_pre_assembly_for_file(const char* file_name) {
             continue;
         }
         
+        /* Repeat blocks are buffered until '.endr', then written count times */
+        if (is_repeat_start(&statement)) {
+            in_repeat_block = TRUE;
+            repeat_count = parse_repeat_count(&statement);
+            repeat_first_line = line_number + 1;
+            repeat_body_size = 0;
+            continue;
+        }
+        if (is_repeat_end(&statement)) {
+            if (output_file.file != NULL && repeat_body_size > 0) {
+                emit_repeat_block(file_name, repeat_body, repeat_body_size, repeat_count,
+                                  repeat_first_line, &sink);
+            }
+            in_repeat_block = FALSE;
+            continue;
+        }
+        if (in_repeat_block) {
+            int line_len = strlen(line);
+            
+            if (output_file.file == NULL) {
+                continue;
+            }
+            /* Expand repeat block buffer if needed */
+            if (repeat_body_size + line_len >= repeat_body_capacity) {
+                int new_capacity = (repeat_body_capacity == 0) ? 1024 : repeat_body_capacity * 2;
+                char* new_body;
+                while (repeat_body_size + line_len >= new_capacity) {
+                    new_capacity *= 2;
+                }
+                new_body = (char*)realloc(repeat_body, new_capacity);
+                if (new_body == NULL) {
+                    report_error(file_name, line_number, ERROR_INTERNAL_ERROR);
+                    has_errors_in_file = TRUE;
+                    continue;
+                }
+                repeat_body = new_body;
+                repeat_body_capacity = new_capacity;
+            }
+            strcpy(repeat_body + repeat_body_size, line);
+            repeat_body_size += line_len;
+            continue;
+        }
+        
+        /* Replace a binary include by its values, loaded in the same order */
+        if (is_binary_include(&statement)) {
+            if (output_file.file != NULL && include_index < g_include_count) {
+                emit_binary_include(&g_includes[include_index], &statement, line, &output_file);
+            }
+            include_index++;
+            continue;
+        }
+        
         /* Check if line is a macro call */
-        if (output_file != NULL) {
-            const char* macro_name = is_macro_call(line);
-            if (macro_name != NULL) {
-                Macro* called_macro = find_macro(macro_name);
+        if (output_file.file != NULL) {
+            Macro* called_macro = find_called_file_macro(&statement);
+            const char* called_library_body = (called_macro == NULL) ? find_called_library_body(&statement) : NULL;
+            if (called_macro != NULL || called_library_body != NULL) {
+                /* Check if line has a label */
+                if (statement.label != NULL) {
+                    /* Write label part, up to and including the ':' */
+                    int label_len = (int)(statement.label - line) + statement.label_length + 1;
+                    tracked_write(line, label_len, &output_file);
+                }
+                /* Write the macro body, with the calls inside it expanded */
                 if (called_macro != NULL) {
-                    /* Check if line has a label */
-                    char* colon_pos = strchr(line, ':');
-                    if (colon_pos != NULL) {
-                        /* Write label part */
-                        int label_len = colon_pos - line + 1;
-                        fwrite(line, 1, label_len, output_file);
-                        /* Write macro body */
-                        fputs(called_macro->body, output_file);
-                    } else {
-                        /* Write macro body to output */
-                        fputs(called_macro->body, output_file);
+                    if (!emit_macro(called_macro, &sink)) {
+                        report_error(file_name, line_number, ERROR_INTERNAL_ERROR);
                     }
+                } else {
+                    tracked_puts(called_library_body, &output_file);
                 }
             } else {
                 /* Write original line to output */
-                fputs(line, output_file);
+                tracked_puts(line, &output_file);
             }
         }
     }
 
-    /* Close files */
-    fclose(input_file);
-    if (output_file != NULL) {
-        fclose(output_file);
-    }
+    /* Close the output */
+    close_output_file(&output_file, output_filename);
+    end_stage(STAGE_MACRO_EXPANSION);
+    free(repeat_body);
     
-    /* Free macros */
+    /* Free macros and interned identifiers */
     free_macros();
+    reset_identifier_table();
     
     /* Return success if no errors occurred */
     return !has_errors_in_file && !has_errors();
 }
+
+void set_pre_assembly_check_only(int check_only) {
+    g_check_only = check_only;
+}
+
+int process_pre_assembly_for_file(const char* file_name) {
+    SourceBuffer source;             /* The input, read once and shared by both passes */
+    char input_filename[256];
+    int success;
+    
+    /* Reset error flag */
+    reset_error_flag();
+    
+    /* Read the whole input file once */
+    sprintf(input_filename, "%s%s", file_name, AS_EXTENSION);
+    begin_stage(STAGE_SOURCE_READ);
+    if (!read_source_file(&source, input_filename)) {
+        end_stage(STAGE_SOURCE_READ);
+        report_error(file_name, 0, ERROR_FILE_OPEN_FAILED);
+        return FALSE;
+    }
+    end_stage(STAGE_SOURCE_READ);
+    
+    success = process_pre_assembly_for_source(file_name, &source);
+    free_source(&source);
+    return success;
+}
+
+int build_macro_library(const char* library_path, char* const file_names[], int file_count) {
+    SourceBuffer source;
+    char input_filename[256];
+    const char** names;
+    const char** bodies;
+    int has_errors_in_files = FALSE;
+    int success = FALSE;
+    int i;
+    
+    /* Reset error flag and start from an empty macro table */
+    reset_error_flag();
+    free_macros();
+    reset_identifier_table();
+    
+    /* Collect the definitions of all files into one table */
+    for (i = 0; i < file_count; i++) {
+        sprintf(input_filename, "%s%s", file_names[i], AS_EXTENSION);
+        if (!read_source_file(&source, input_filename)) {
+            report_error(file_names[i], 0, ERROR_FILE_OPEN_FAILED);
+            has_errors_in_files = TRUE;
+            continue;
+        }
+        if (collect_macro_definitions(file_names[i], &source)) {
+            has_errors_in_files = TRUE;
+        }
+        free_source(&source);
+    }
+    
+    /* Library macros are stored expanded, so calls between them need no resolution at load time */
+    if (!has_errors_in_files && resolve_all_macro_calls()) {
+        has_errors_in_files = TRUE;
+    }
+    
+    /* Only write the library if every definition was valid */
+    if (!has_errors_in_files) {
+        names = (const char**)malloc((g_macro_count + 1) * sizeof(const char*));
+        bodies = (const char**)malloc((g_macro_count + 1) * sizeof(const char*));
+        if (names != NULL && bodies != NULL) {
+            int expanded_all = TRUE;
+            for (i = 0; i < g_macro_count; i++) {
+                names[i] = g_macros[i].name;
+                bodies[i] = g_macros[i].calls_macros ? expand_macro_to_string(&g_macros[i]) : g_macros[i].body;
+                if (bodies[i] == NULL) {
+                    expanded_all = FALSE;
+                }
+            }
+            if (expanded_all) {
+                success = write_macro_library(library_path, names, bodies, g_macro_count);
+            } else {
+                report_error(library_path, 0, ERROR_INTERNAL_ERROR);
+            }
+            for (i = 0; i < g_macro_count; i++) {
+                if (bodies[i] != g_macros[i].body) {
+                    free((char*)bodies[i]);
+                }
+            }
+        } else {
+            report_error(library_path, 0, ERROR_INTERNAL_ERROR);
+        }
+        free(names);
+        free(bodies);
+    }
+    
+    free_macros();
+    reset_identifier_table();
+    return success;
+}
@@ -7,6 +7,7 @@
 
 #include "definitions.h" /* Includes global constants like MAX_LINE_LENGTH, MAX_LABEL_LENGTH, etc. */
 #include "utils.h"       /* Includes general utility functions like is_legal_label, is_reserved_keyword, etc. */
+#include "source_buffer.h" /* Includes SourceBuffer */
 
 /**
  * @brief This header file declares functions for the pre-assembler stage of the assembler.
@@ -15,6 +16,35 @@
  * logic for identifying, validating, and expanding macros according to the defined rules.
  */
 
+/* --- Repeat Block Constants --- */
+
+/**
+ * @brief Largest count of a '.rept' block; a block repeated more often cannot fit in memory.
+ */
+#define MAX_REPEAT_COUNT MEMORY_SIZE
+
+/* --- Binary Include Constants --- */
+
+/**
+ * @brief Widest value of a '.incbin' file, in bytes (values are signed, little-endian).
+ */
+#define MAX_INCBIN_WIDTH 2
+
+/**
+ * @brief Range of a value stored in one 10-bit data word (two's complement).
+ */
+#define MIN_DATA_WORD_VALUE (-512)
+#define MAX_DATA_WORD_VALUE 511
+
+/**
+ * @brief Values per '.data' line written for a '.incbin'.
+ * A line of n values takes at most INCBIN_LINE_OVERHEAD + n * INCBIN_VALUE_TEXT_WIDTH
+ * characters (64 for 10 values); a label leaves room for fewer values on the first line.
+ */
+#define INCBIN_VALUES_PER_LINE 10
+#define INCBIN_VALUE_TEXT_WIDTH 6   /* Longest value with its separator: ", -512" */
+#define INCBIN_LINE_OVERHEAD 4      /* ".data " less the separator of the first value */
+
 /* --- Pre-Assembler Core Function --- */
 
 /**
@@ -22,12 +52,44 @@
  * This function reads the input .as file, identifies and expands macros,
  * and writes the processed content to an .am file. It also performs
  * initial validation checks specific to macro definitions.
+ * A block of lines between '.rept N' and '.endr' is written N times; the block
+ * is classified once and macro calls inside it are expanded in every copy.
+ * A '.incbin "file", width' line is replaced by '.data' lines holding the
+ * values of the binary file (read and range-checked during macro collection).
  * @param file_name The base name of the input assembly source file (e.g., "my_program" for "my_program.as").
  * @return TRUE if the pre-assembly stage completed successfully without critical errors
  * that prevent further processing, FALSE otherwise.
  */
 int process_pre_assembly_for_file(const char* file_name);
 
+/**
+ * @brief Pre-assembles a source that is already in memory (e.g. a member of a bundle).
+ * Behaves exactly like process_pre_assembly_for_file, without reading the .as file.
+ * @param file_name The base name of the source, used in error messages and for the .am file.
+ * @param source The source contents.
+ * @return TRUE if the pre-assembly stage completed successfully, FALSE otherwise.
+ */
+int process_pre_assembly_for_source(const char* file_name, SourceBuffer* source);
+
+/**
+ * @brief Selects check mode, in which pre-assembly only validates the source.
+ * Macro definitions are collected and every error is reported as usual, but
+ * macros are not expanded and no .am file is written.
+ * @param check_only TRUE to validate only, FALSE for normal pre-assembly.
+ */
+void set_pre_assembly_check_only(int check_only);
+
+/**
+ * @brief Compiles the macro definitions of one or more source files into a macro library.
+ * Every 'mcro' definition is validated exactly as during pre-assembly; the library is
+ * written only if no errors were found. Libraries are loaded with load_macro_library.
+ * @param library_path The path of the library (.mlib) file to create.
+ * @param file_names The base names of the input files (without the .as extension).
+ * @param file_count The number of input files.
+ * @return TRUE if the library was written, FALSE otherwise.
+ */
+int build_macro_library(const char* library_path, char* const file_names[], int file_count);
+
 /* --- Macro-Related Utility Functions (for internal use within pre_assembler.c) --- */
 
 /**
@@ -0,0 +1,86 @@
+#include "source_buffer.h"
+#include "manifest.h"
+
+#include <stdlib.h>  /* For malloc, realloc, free */
+#include <string.h>  /* For memchr, memcpy */
+
+/* Initial capacity of a source buffer; most sources fit in a single read */
+#define SOURCE_INITIAL_CAPACITY 16384
+
+/* --- Public Functions Implementation --- */
+
+int read_source_file(SourceBuffer* source, const char* path) {
+    TrackedFile file;
+    unsigned long capacity = SOURCE_INITIAL_CAPACITY;
+    unsigned long read_length;
+
+    source->data = NULL;
+    source->size = 0;
+    source->position = 0;
+
+    if (!tracked_open(&file, path, "r")) {
+        return FALSE;
+    }
+
+    source->data = (char*)malloc(capacity);
+    while (source->data != NULL) {
+        read_length = tracked_read(source->data + source->size, capacity - source->size, &file);
+        source->size += read_length;
+        if (source->size < capacity) {
+            break;  /* End of file (a short read) */
+        }
+
+        /* Buffer full: double it and keep reading */
+        {
+            char* new_data = (char*)realloc(source->data, capacity * 2);
+            if (new_data == NULL) {
+                free(source->data);
+                source->data = NULL;
+                break;
+            }
+            source->data = new_data;
+            capacity *= 2;
+        }
+    }
+
+    tracked_close(&file, "input", path);
+    if (source->data == NULL) {
+        source->size = 0;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+char* source_gets(char* buffer, int size, SourceBuffer* source) {
+    unsigned long remaining;
+    unsigned long length;
+    const char* newline;
+
+    if (source->position >= source->size || size < 2) {
+        return NULL;
+    }
+
+    /* Copy up to and including the next newline, but no more than size - 1 bytes */
+    remaining = source->size - source->position;
+    length = (remaining < (unsigned long)(size - 1)) ? remaining : (unsigned long)(size - 1);
+    newline = (const char*)memchr(source->data + source->position, '\n', length);
+    if (newline != NULL) {
+        length = (unsigned long)(newline - (source->data + source->position)) + 1;
+    }
+
+    memcpy(buffer, source->data + source->position, length);
+    buffer[length] = '\0';
+    source->position += length;
+    return buffer;
+}
+
+void rewind_source(SourceBuffer* source) {
+    source->position = 0;
+}
+
+void free_source(SourceBuffer* source) {
+    free(source->data);
+    source->data = NULL;
+    source->size = 0;
+    source->position = 0;
+}
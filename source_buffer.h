@@ -0,0 +1,58 @@
+#ifndef ASSEMBLER_SOURCE_BUFFER_H
+#define ASSEMBLER_SOURCE_BUFFER_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes TRUE/FALSE */
+
+/**
+ * @brief This header file declares the in-memory source buffer.
+ * A source file is opened, read and closed exactly once, in as few large reads
+ * as possible, and every pass of the assembler then walks its lines in memory.
+ * This replaces reopening and rereading the input for each pass, which for the
+ * typical small source file costs more in system calls than the passes themselves.
+ */
+
+/* --- Source Buffer Definitions --- */
+
+/**
+ * @brief The complete contents of a source file and a read position in it.
+ */
+typedef struct {
+    char* data;             /* File contents (not null-terminated) */
+    unsigned long size;     /* Number of bytes in data */
+    unsigned long position; /* Offset of the next line to read */
+} SourceBuffer;
+
+/* --- Source Buffer Functions --- */
+
+/**
+ * @brief Reads a whole file into a source buffer and records it in the manifest as an input.
+ * @param source The source buffer to fill.
+ * @param path The path of the file to read.
+ * @return TRUE if the file was read, FALSE if it could not be opened or memory ran out.
+ */
+int read_source_file(SourceBuffer* source, const char* path);
+
+/**
+ * @brief Copies the next line of a source buffer (like fgets).
+ * At most size - 1 bytes are copied; a line longer than that is returned in pieces.
+ * @param buffer The buffer that receives the line, including its newline.
+ * @param size The size of the buffer.
+ * @param source The source buffer to read from.
+ * @return buffer on success, or NULL at the end of the buffer.
+ */
+char* source_gets(char* buffer, int size, SourceBuffer* source);
+
+/**
+ * @brief Moves the read position of a source buffer back to its first line.
+ * @param source The source buffer.
+ */
+void rewind_source(SourceBuffer* source);
+
+/**
+ * @brief Releases the contents of a source buffer.
+ * @param source The source buffer.
+ */
+void free_source(SourceBuffer* source);
+
+#endif /* ASSEMBLER_SOURCE_BUFFER_H */
@@ -0,0 +1,118 @@
+#include "statistics.h"
+#include "trace.h"
+
+#include <stdio.h>   /* For printf */
+#include <string.h>  /* For memset */
+
+/* --- Statistics Structures --- */
+
+/**
+ * @brief Accumulated cost of one stage
+ */
+typedef struct {
+    double seconds;                                     /* Total wall-clock time */
+    unsigned long counters[NUM_HARDWARE_COUNTERS];      /* Total hardware counter deltas */
+    long runs;                                          /* Number of times the stage ran */
+    double begin_seconds;                               /* Time at the last begin_stage */
+    CounterSample begin_sample;                         /* Counters at the last begin_stage */
+} StageStatistics;
+
+/* Display names, in Stage order */
+static const char* stage_names[NUM_STAGES] = {
+    "source read", "macro collection", "macro expansion"
+};
+
+/* --- Global Variables for Statistics --- */
+
+static int g_statistics_enabled = FALSE;    /* Whether stages are measured */
+static int g_counters_enabled = FALSE;      /* Whether hardware counters are read */
+static StageStatistics g_stages[NUM_STAGES];
+
+/* --- Public Functions Implementation --- */
+
+void enable_statistics(int with_hardware_counters) {
+    memset(g_stages, 0, sizeof(g_stages));
+    g_statistics_enabled = TRUE;
+    g_counters_enabled = with_hardware_counters && open_hardware_counters();
+    if (with_hardware_counters && !g_counters_enabled) {
+        printf("Hardware performance counters are not available; reporting time only.\n");
+    }
+}
+
+void begin_stage(Stage stage) {
+    trace_begin(stage_names[stage], "stage");
+    if (!g_statistics_enabled) {
+        return;
+    }
+    if (g_counters_enabled) {
+        read_hardware_counters(&g_stages[stage].begin_sample);
+    }
+    g_stages[stage].begin_seconds = read_wall_clock_seconds();
+}
+
+void end_stage(Stage stage) {
+    StageStatistics* statistics;
+    CounterSample end_sample;
+    int i;
+
+    trace_end(stage_names[stage], "stage");
+    if (!g_statistics_enabled) {
+        return;
+    }
+
+    statistics = &g_stages[stage];
+    statistics->seconds += read_wall_clock_seconds() - statistics->begin_seconds;
+    statistics->runs++;
+
+    if (g_counters_enabled) {
+        read_hardware_counters(&end_sample);
+        for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+            statistics->counters[i] += end_sample.values[i] - statistics->begin_sample.values[i];
+        }
+    }
+}
+
+void print_statistics() {
+    CounterSample availability;
+    int stage;
+    int i;
+
+    if (!g_statistics_enabled) {
+        return;
+    }
+
+    printf("\n%-18s %6s %10s", "stage", "runs", "time(ms)");
+    if (g_counters_enabled) {
+        for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+            printf(" %14s", hardware_counter_name((HardwareCounter)i));
+        }
+        printf(" %6s", "IPC");
+    }
+    printf("\n");
+
+    read_hardware_counters(&availability);
+    for (stage = 0; stage < NUM_STAGES; stage++) {
+        StageStatistics* statistics = &g_stages[stage];
+        printf("%-18s %6ld %10.3f", stage_names[stage], statistics->runs, statistics->seconds * 1000.0);
+        if (g_counters_enabled) {
+            for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+                if (availability.available[i]) {
+                    printf(" %14lu", statistics->counters[i]);
+                } else {
+                    printf(" %14s", "n/a");
+                }
+            }
+            if (statistics->counters[COUNTER_CYCLES] > 0) {
+                printf(" %6.2f", (double)statistics->counters[COUNTER_INSTRUCTIONS] /
+                                 (double)statistics->counters[COUNTER_CYCLES]);
+            } else {
+                printf(" %6s", "n/a");
+            }
+        }
+        printf("\n");
+    }
+
+    close_hardware_counters();
+    g_statistics_enabled = FALSE;
+    g_counters_enabled = FALSE;
+}
@@ -0,0 +1,55 @@
+#ifndef ASSEMBLER_STATISTICS_H
+#define ASSEMBLER_STATISTICS_H
+
+/* Include necessary project definitions */
+#include "definitions.h"   /* Includes TRUE/FALSE */
+#include "perf_counters.h" /* Includes CounterSample and the hardware counter list */
+
+/**
+ * @brief This header file declares the per-stage statistics of the --stats mode.
+ * Each stage of the assembler is bracketed with begin_stage/end_stage; when
+ * statistics are enabled, the wall-clock time and (optionally) the hardware
+ * counters of every stage are accumulated over all processed files and printed
+ * at the end of the run. The same brackets feed the --trace timeline (trace.h).
+ * When statistics and tracing are disabled the brackets cost two flag tests.
+ */
+
+/* --- Stage Definitions --- */
+
+/**
+ * @brief The stages of the assembler that are measured.
+ */
+typedef enum {
+    STAGE_SOURCE_READ = 0,      /* Reading the whole source file into memory */
+    STAGE_MACRO_COLLECTION,     /* Pre-assembler: collecting macro definitions */
+    STAGE_MACRO_EXPANSION,      /* Pre-assembler: expanding macro calls and writing the .am file */
+    NUM_STAGES
+} Stage;
+
+/* --- Statistics Functions --- */
+
+/**
+ * @brief Enables statistics collection for the rest of the run.
+ * @param with_hardware_counters TRUE to also read the hardware performance counters.
+ */
+void enable_statistics(int with_hardware_counters);
+
+/**
+ * @brief Marks the beginning of a stage.
+ * @param stage The stage that begins.
+ */
+void begin_stage(Stage stage);
+
+/**
+ * @brief Marks the end of a stage and adds its cost to the stage totals.
+ * @param stage The stage that ends (must match the last begin_stage for it).
+ */
+void end_stage(Stage stage);
+
+/**
+ * @brief Prints the accumulated per-stage statistics to standard output and
+ * releases the hardware counters. Does nothing if statistics are disabled.
+ */
+void print_statistics();
+
+#endif /* ASSEMBLER_STATISTICS_H */
@@ -1 +1,174 @@
- 
\ No newline at end of file
+#include "symbol_table.h"
+
+#include <stdlib.h>  /* For malloc, realloc, free */
+#include <string.h>  /* For memcpy, memcmp */
+
+/* --- Identifier Table Structures --- */
+
+/**
+ * @brief Structure to represent an interned identifier
+ */
+typedef struct {
+    char* name;                 /* Null-terminated copy of the identifier */
+    int length;                 /* Length of the identifier */
+    unsigned long hash;         /* Hash of the identifier, kept to speed up rehashing */
+    IdentifierClass class_type; /* Classification computed on first sight */
+} Identifier;
+
+/* --- Global Variables for the Identifier Table --- */
+
+static Identifier* g_identifiers = NULL;  /* Interned identifiers, indexed by id */
+static int g_identifier_count = 0;        /* Number of interned identifiers */
+static int g_identifier_capacity = 0;     /* Capacity of the identifiers array */
+
+static int* g_hash_slots = NULL;          /* Open-addressing hash index of ids (-1 = empty) */
+static int g_hash_slot_count = 0;         /* Number of hash slots (a power of two) */
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Computes the FNV-1a hash of an identifier
+ * @param name The first character of the identifier
+ * @param length The number of characters to hash
+ * @return The hash value
+ */
+static unsigned long hash_identifier(const char* name, int length) {
+    unsigned long hash = 2166136261UL;
+    int i;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Finds the hash slot holding an identifier, or the empty slot where it belongs
+ * @param name The first character of the identifier
+ * @param length The number of characters in the identifier
+ * @param hash The hash of the identifier
+ * @return The slot index
+ */
+static int find_slot(const char* name, int length, unsigned long hash) {
+    int mask = g_hash_slot_count - 1;
+    int slot = (int)(hash & (unsigned long)mask);
+    while (g_hash_slots[slot] != INVALID_IDENTIFIER_ID) {
+        Identifier* entry = &g_identifiers[g_hash_slots[slot]];
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->name, name, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Doubles the hash index and re-inserts all identifiers
+ * @return TRUE on success, FALSE if memory allocation failed
+ */
+static int grow_hash_slots() {
+    int new_count = (g_hash_slot_count == 0) ? 64 : g_hash_slot_count * 2;
+    int* new_slots = (int*)malloc(new_count * sizeof(int));
+    int i;
+
+    if (new_slots == NULL) {
+        return FALSE;
+    }
+    for (i = 0; i < new_count; i++) {
+        new_slots[i] = INVALID_IDENTIFIER_ID;
+    }
+
+    free(g_hash_slots);
+    g_hash_slots = new_slots;
+    g_hash_slot_count = new_count;
+
+    for (i = 0; i < g_identifier_count; i++) {
+        Identifier* entry = &g_identifiers[i];
+        g_hash_slots[find_slot(entry->name, entry->length, entry->hash)] = i;
+    }
+    return TRUE;
+}
+
+/* --- Public Functions Implementation --- */
+
+int intern_identifier(const char* name) {
+    return intern_identifier_span(name, (int)strlen(name));
+}
+
+int intern_identifier_span(const char* name, int length) {
+    unsigned long hash;
+    int slot;
+    Identifier* entry;
+
+    /* Keep the index at most half full */
+    if ((g_identifier_count + 1) * 2 > g_hash_slot_count && !grow_hash_slots()) {
+        return INVALID_IDENTIFIER_ID;
+    }
+
+    hash = hash_identifier(name, length);
+    slot = find_slot(name, length, hash);
+    if (g_hash_slots[slot] != INVALID_IDENTIFIER_ID) {
+        return g_hash_slots[slot];
+    }
+
+    /* First sight: copy, classify and index the identifier */
+    if (g_identifier_count >= g_identifier_capacity) {
+        int new_capacity = (g_identifier_capacity == 0) ? 32 : g_identifier_capacity * 2;
+        Identifier* new_identifiers = (Identifier*)realloc(g_identifiers, new_capacity * sizeof(Identifier));
+        if (new_identifiers == NULL) {
+            return INVALID_IDENTIFIER_ID;
+        }
+        g_identifiers = new_identifiers;
+        g_identifier_capacity = new_capacity;
+    }
+
+    entry = &g_identifiers[g_identifier_count];
+    entry->name = (char*)malloc(length + 1);
+    if (entry->name == NULL) {
+        return INVALID_IDENTIFIER_ID;
+    }
+    memcpy(entry->name, name, length);
+    entry->name[length] = '\0';
+    entry->length = length;
+    entry->hash = hash;
+    entry->class_type = classify_identifier(entry->name);
+
+    g_hash_slots[slot] = g_identifier_count;
+    return g_identifier_count++;
+}
+
+int find_identifier_span(const char* name, int length) {
+    if (g_identifier_count == 0) {
+        return INVALID_IDENTIFIER_ID;
+    }
+    return g_hash_slots[find_slot(name, length, hash_identifier(name, length))];
+}
+
+IdentifierClass get_identifier_class(int id) {
+    if (id < 0 || id >= g_identifier_count) {
+        return IDENTIFIER_EMPTY;
+    }
+    return g_identifiers[id].class_type;
+}
+
+const char* get_identifier_name(int id) {
+    if (id < 0 || id >= g_identifier_count) {
+        return NULL;
+    }
+    return g_identifiers[id].name;
+}
+
+void reset_identifier_table() {
+    int i;
+    for (i = 0; i < g_identifier_count; i++) {
+        free(g_identifiers[i].name);
+    }
+    free(g_identifiers);
+    free(g_hash_slots);
+    g_identifiers = NULL;
+    g_identifier_count = 0;
+    g_identifier_capacity = 0;
+    g_hash_slots = NULL;
+    g_hash_slot_count = 0;
+}
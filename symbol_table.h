@@ -1 +1,69 @@
- 
\ No newline at end of file
+#ifndef ASSEMBLER_SYMBOL_TABLE_H
+#define ASSEMBLER_SYMBOL_TABLE_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes global constants like MAX_LABEL_LENGTH */
+#include "utils.h"       /* Includes the IdentifierClass enumeration and classify_identifier */
+
+/**
+ * @brief This header file declares the symbol table module of the assembler.
+ * Its foundation is an identifier interning layer shared by the pre-assembler and
+ * the assembly passes: every distinct name (macro name, label, '.entry'/'.extern'
+ * name or operand symbol) is classified once, on first sight, and receives a stable
+ * integer id. Later stages compare names by id instead of by strcmp.
+ */
+
+/**
+ * @brief Value returned by the interning functions when a name cannot be interned.
+ */
+#define INVALID_IDENTIFIER_ID (-1)
+
+/* --- Identifier Interning Functions --- */
+
+/**
+ * @brief Returns the stable id of an identifier, interning it on first sight.
+ * The identifier is classified (keyword kind, legal label, too long, bad characters)
+ * only when it is seen for the first time.
+ * @param name The identifier to intern (must be a null-terminated string).
+ * @return A non-negative id, or INVALID_IDENTIFIER_ID if memory allocation failed.
+ */
+int intern_identifier(const char* name);
+
+/**
+ * @brief Returns the id of an identifier of a given length, interning it on first sight.
+ * Useful for tokens inside a line, which are not null-terminated.
+ * @param name A pointer to the first character of the identifier.
+ * @param length The number of characters in the identifier.
+ * @return A non-negative id, or INVALID_IDENTIFIER_ID if memory allocation failed.
+ */
+int intern_identifier_span(const char* name, int length);
+
+/**
+ * @brief Looks up an identifier without interning it.
+ * @param name A pointer to the first character of the identifier.
+ * @param length The number of characters in the identifier.
+ * @return The id of the identifier, or INVALID_IDENTIFIER_ID if it was never interned.
+ */
+int find_identifier_span(const char* name, int length);
+
+/**
+ * @brief Returns the classification computed when the identifier was interned.
+ * @param id An id returned by intern_identifier.
+ * @return The IdentifierClass of the identifier.
+ */
+IdentifierClass get_identifier_class(int id);
+
+/**
+ * @brief Returns the text of an interned identifier.
+ * @param id An id returned by intern_identifier.
+ * @return The null-terminated name, or NULL if the id is invalid.
+ */
+const char* get_identifier_name(int id);
+
+/**
+ * @brief Releases all interned identifiers. Previously returned ids become invalid.
+ * Called at the beginning of processing each new assembly file.
+ */
+void reset_identifier_table();
+
+#endif /* ASSEMBLER_SYMBOL_TABLE_H */
@@ -0,0 +1,5 @@
+; A lookup table included from a binary file of 16-bit little-endian values
+MAIN: lea TABLE, r1
+prn r1
+stop
+TABLE: .incbin "incbin_table.bin", 2
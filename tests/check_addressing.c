@@ -0,0 +1,158 @@
+/*
+ * Cross-check of the compile-time instruction tables in utils.c against the
+ * instruction specification.
+ *
+ * The specification is written out again below, independently of the
+ * INSTRUCTION_SPEC list in utils.c: for every opcode, by name, its operand
+ * count and the legal source and destination addressing methods as digit
+ * strings. Every opcode x source method x destination method combination
+ * (16 x 4 x 4 = 256) is generated and is_legal_addressing() is compared with
+ * the legality derived from the specification; get_operand_count() and the
+ * opcode numbering are checked too. A missing operand position is a
+ * "don't care", as documented for is_legal_addressing().
+ *
+ * get_instruction_word_count() is checked for every opcode x source method x
+ * destination method as well, against the encoding rules: a first word, one
+ * information word per operand (two for a matrix operand), and a single
+ * shared word for two register operands. Methods of missing operands must be
+ * ignored, so the 0- and 1-operand forms take the same count for all of them.
+ *
+ * Usage: check_addressing (exit status 0 when every combination matches)
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utils.h"
+
+/* --- Specification --- */
+
+typedef struct {
+    const char* name;           /* Opcode name */
+    int operand_count;          /* Number of operands */
+    const char* source;         /* Legal source methods (digits), "" if no source operand */
+    const char* destination;    /* Legal destination methods (digits), "" if no operand */
+} InstructionSpec;
+
+/* 0 = immediate, 1 = direct, 2 = matrix, 3 = register direct */
+static const InstructionSpec g_specification[] = {
+    { "mov",  2, "0123", "123"  },
+    { "cmp",  2, "0123", "0123" },
+    { "add",  2, "0123", "123"  },
+    { "sub",  2, "0123", "123"  },
+    { "not",  1, "",     "123"  },
+    { "clr",  1, "",     "123"  },
+    { "lea",  2, "12",   "123"  },
+    { "inc",  1, "",     "123"  },
+    { "dec",  1, "",     "123"  },
+    { "jmp",  1, "",     "12"   },
+    { "bne",  1, "",     "12"   },
+    { "red",  1, "",     "123"  },
+    { "prn",  1, "",     "0123" },
+    { "jsr",  1, "",     "12"   },
+    { "rts",  0, "",     ""     },
+    { "stop", 0, "",     ""     }
+};
+
+#define SPEC_COUNT ((int)(sizeof(g_specification) / sizeof(g_specification[0])))
+
+/**
+ * @brief Checks whether an operand position accepts a method
+ * @param methods The legal methods as digits, "" if the position has no operand
+ * @param method The addressing method
+ * @return 1 if the method is accepted (always, for a missing operand), 0 otherwise
+ */
+static int accepts(const char* methods, int method) {
+    return methods[0] == '\0' || strchr(methods, '0' + method) != NULL;
+}
+
+/**
+ * @brief Computes the words of an instruction from the encoding rules
+ * @param operand_count The number of operands (0-2)
+ * @param source The source addressing method (used only with 2 operands)
+ * @param destination The destination addressing method (unused with no operands)
+ * @return The expected number of words
+ */
+static int expected_word_count(int operand_count, int source, int destination) {
+    int words = 1;
+
+    if (operand_count == 2 && source == 3 && destination == 3) {
+        return words + 1;
+    }
+    if (operand_count >= 1) {
+        words += (destination == 2) ? 2 : 1;
+    }
+    if (operand_count == 2) {
+        words += (source == 2) ? 2 : 1;
+    }
+    return words;
+}
+
+int main(void) {
+    int combinations = 0;
+    int failures = 0;
+    int opcode, source, destination;
+
+    if (SPEC_COUNT != NUM_OPCODES) {
+        printf("FAIL  specification lists %d opcodes, expected %d\n", SPEC_COUNT, NUM_OPCODES);
+        return 1;
+    }
+
+    for (opcode = 0; opcode < NUM_OPCODES; opcode++) {
+        const InstructionSpec* spec = &g_specification[opcode];
+        int value = -1;
+
+        if (!get_opcode_value(spec->name, &value) || value != opcode) {
+            printf("FAIL  %s: opcode %d, expected %d\n", spec->name, value, opcode);
+            failures++;
+        }
+        if (get_operand_count(opcode) != spec->operand_count) {
+            printf("FAIL  %s: %d operands, expected %d\n", spec->name, get_operand_count(opcode), spec->operand_count);
+            failures++;
+        }
+
+        for (source = 0; source < NUM_ADDRESSING_METHODS; source++) {
+            for (destination = 0; destination < NUM_ADDRESSING_METHODS; destination++) {
+                int expected = accepts(spec->source, source) && accepts(spec->destination, destination);
+                int actual = is_legal_addressing(opcode, source, destination) ? 1 : 0;
+                int words = get_instruction_word_count(spec->operand_count, source, destination);
+                int expected_words = expected_word_count(spec->operand_count, source, destination);
+                combinations++;
+                if (actual != expected) {
+                    printf("FAIL  %s source %d destination %d: %s, expected %s\n", spec->name, source, destination,
+                           actual ? "legal" : "illegal", expected ? "legal" : "illegal");
+                    failures++;
+                }
+                if (words != expected_words) {
+                    printf("FAIL  %s source %d destination %d: %d words, expected %d\n", spec->name, source,
+                           destination, words, expected_words);
+                    failures++;
+                }
+            }
+        }
+    }
+
+    /* Out-of-range arguments are rejected */
+    if (is_legal_addressing(-1, 0, 0) || is_legal_addressing(NUM_OPCODES, 0, 0) ||
+        is_legal_addressing(0, NUM_ADDRESSING_METHODS, 1) || is_legal_addressing(0, 0, -1) ||
+        get_operand_count(NUM_OPCODES) != -1) {
+        printf("FAIL  out-of-range opcode or addressing method accepted\n");
+        failures++;
+    }
+
+    /* The encoding rules by example: a matrix operand takes two words, two registers share one */
+    if (get_instruction_word_count(1, 0, 2) != 3 || get_instruction_word_count(2, 2, 2) != 5 ||
+        get_instruction_word_count(2, 3, 3) != 2 || get_instruction_word_count(2, 3, 1) != 3 ||
+        get_instruction_word_count(0, 2, 2) != 1) {
+        printf("FAIL  instruction word counts do not follow the encoding rules\n");
+        failures++;
+    }
+
+    if (failures != 0) {
+        printf("%d of %d addressing checks failed.\n", failures, combinations);
+        return 1;
+    }
+    printf("All %d opcode x addressing combinations match the specification, word counts included.\n",
+           combinations);
+    return 0;
+}
@@ -0,0 +1,23 @@
+; Macros that call other macros, including one defined later in the file
+mcro ClearPair
+clr r1
+clr r2
+mcroend
+
+mcro Reset ; Calls ClearPair, then a macro defined below
+ClearPair
+Report
+mcroend
+
+MAIN: mov r3, LENGTH
+Reset
+prn #-5
+END: Reset
+
+mcro Report
+prn r1
+prn r2
+mcroend
+
+stop
+LENGTH: .data 6
@@ -0,0 +1,81 @@
+#!/bin/bash
+#
+# Round trip of the --pack mode: pack the outputs of a run, extract them with
+# extract_pack into an empty directory, and compare every member with the .am
+# file a normal run writes. The inputs are named by a relative path in a
+# subdirectory, by an absolute path and by an absolute directory argument.
+#
+# Usage: tests/pack_roundtrip.sh <path-to-assembler> <path-to-extract_pack>
+
+ASSEMBLER="$1"
+EXTRACT="$2"
+if [ ! -x "$ASSEMBLER" ] || [ ! -x "$EXTRACT" ]; then
+    echo "Usage: $0 <path-to-assembler> <path-to-extract_pack>"
+    exit 2
+fi
+ASSEMBLER="$(cd "$(dirname "$ASSEMBLER")" && pwd)/$(basename "$ASSEMBLER")"
+EXTRACT="$(cd "$(dirname "$EXTRACT")" && pwd)/$(basename "$EXTRACT")"
+SAMPLES="$(cd "$(dirname "$0")" && pwd)"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+FAILURES=0
+
+# Inputs: a relative subdirectory, an absolute file and an absolute directory
+mkdir -p "$WORK_DIR/run/src" "$WORK_DIR/abs" "$WORK_DIR/tree/deep"
+cp "$SAMPLES/valid_macro_example_1.as" "$WORK_DIR/run/src/relative.as"
+cp "$SAMPLES/nested_macro_example_1.as" "$WORK_DIR/abs/absolute.as"
+cp "$SAMPLES/repeat_block_example_1.as" "$WORK_DIR/tree/deep/walked.as"
+
+# Reference outputs from a normal run
+cd "$WORK_DIR/run" || exit 2
+if ! "$ASSEMBLER" src/relative "$WORK_DIR/abs/absolute" "$WORK_DIR/tree" > /dev/null; then
+    echo "FAIL  reference run failed"
+    exit 1
+fi
+mkdir "$WORK_DIR/expected"
+cp src/relative.am "$WORK_DIR/expected/relative.am"
+cp "$WORK_DIR/abs/absolute.am" "$WORK_DIR/expected/absolute.am"
+cp "$WORK_DIR/tree/deep/walked.am" "$WORK_DIR/expected/walked.am"
+rm -f src/relative.am "$WORK_DIR/abs/absolute.am" "$WORK_DIR/tree/deep/walked.am"
+
+# Packed run: no .am file may be created
+if ! "$ASSEMBLER" --pack="$WORK_DIR/out.pack" src/relative "$WORK_DIR/abs/absolute" "$WORK_DIR/tree" > /dev/null; then
+    echo "FAIL  packed run failed"
+    exit 1
+fi
+if [ -e src/relative.am ] || [ -e "$WORK_DIR/abs/absolute.am" ] || [ -e "$WORK_DIR/tree/deep/walked.am" ]; then
+    echo "FAIL  packed run wrote .am files"
+    FAILURES=$((FAILURES + 1))
+fi
+
+# Extract into an empty directory; absolute names lose their leading '/'
+mkdir "$WORK_DIR/extract"
+cd "$WORK_DIR/extract" || exit 2
+if ! "$EXTRACT" "$WORK_DIR/out.pack" > /dev/null; then
+    echo "FAIL  extract_pack failed"
+    FAILURES=$((FAILURES + 1))
+fi
+
+# check_member <extracted path> <expected file>
+check_member() {
+    if [ ! -f "$1" ]; then
+        echo "FAIL  missing member: $1"
+        FAILURES=$((FAILURES + 1))
+    elif ! cmp -s "$1" "$2"; then
+        echo "FAIL  member differs from a normal run: $1"
+        FAILURES=$((FAILURES + 1))
+    else
+        echo "PASS  $1"
+    fi
+}
+
+check_member "src/relative.am" "$WORK_DIR/expected/relative.am"
+check_member "${WORK_DIR#/}/abs/absolute.am" "$WORK_DIR/expected/absolute.am"
+check_member "${WORK_DIR#/}/tree/deep/walked.am" "$WORK_DIR/expected/walked.am"
+
+if [ $FAILURES -ne 0 ]; then
+    echo "$FAILURES pack round-trip check(s) failed."
+    exit 1
+fi
+echo "Pack round trip passed."
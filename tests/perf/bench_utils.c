@@ -0,0 +1,369 @@
+/*
+ * Micro-benchmarks for the utils.c primitives on every line's hot path:
+ * trim_whitespace, skip_whitespace, is_reserved_keyword, is_legal_label,
+ * get_opcode_value, get_register_number and convert_decimal_to_unique_base4.
+ *
+ * The inputs are the lines and tokens of a corpus of assembly sources, so the
+ * token distribution (opcodes, registers, labels, numbers, punctuation) is the
+ * realistic one. Each benchmark reports ns/op and bytes/ns (bytes of input
+ * consumed per nanosecond), and can be saved to or compared with a baseline file.
+ * With --counters, the hardware performance counters are read around each
+ * benchmark (Linux) and reported per operation, together with bytes/cycle.
+ *
+ * Usage: bench_utils [--counters] [--save=<baseline>] [--baseline=<baseline>] <source.as>...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utils.h"
+#include "perf_counters.h"
+
+/* --- Benchmark Constants --- */
+#define MAX_CORPUS_LINES 100000
+#define MAX_CORPUS_TOKENS 400000
+#define MIN_BENCH_SECONDS 0.2     /* Each benchmark runs at least this long */
+#define BASE4_BUFFER_SIZE 6
+#define SAVE_OPTION "--save="
+#define BASELINE_OPTION "--baseline="
+#define COUNTERS_OPTION "--counters"
+#define MAX_BENCHMARKS 16
+#define MAX_BENCH_NAME_LENGTH 64
+
+/* --- Corpus --- */
+
+static char* g_lines[MAX_CORPUS_LINES];     /* Lines of the corpus, newline included */
+static int g_line_count = 0;
+static char* g_tokens[MAX_CORPUS_TOKENS];   /* Tokens of the corpus (split at whitespace and commas) */
+static int g_token_count = 0;
+static int g_numbers[MAX_CORPUS_TOKENS];    /* Numeric tokens ("#-5", "10") of the corpus */
+static int g_number_count = 0;
+
+/* Sink that keeps the compiler from discarding benchmarked calls */
+static volatile long g_sink = 0;
+
+/* --- Results --- */
+
+typedef struct {
+    char name[MAX_BENCH_NAME_LENGTH];
+    double ns_per_op;
+    double bytes_per_ns;
+    double counters_per_op[NUM_HARDWARE_COUNTERS];  /* Hardware counter deltas per operation */
+    double bytes_per_cycle;
+} BenchResult;
+
+static BenchResult g_results[MAX_BENCHMARKS];
+static int g_result_count = 0;
+static int g_counters_enabled = FALSE;              /* Whether hardware counters are read */
+static CounterSample g_counter_availability;        /* Which hardware counters could be read */
+
+/**
+ * @brief Allocates a copy of part of a string
+ */
+static char* copy_span(const char* start, size_t length) {
+    char* copy = (char*)malloc(length + 1);
+    if (copy == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    memcpy(copy, start, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+/**
+ * @brief Splits a line into tokens and records the numeric ones
+ */
+static void tokenize_line(const char* line) {
+    const char* p = line;
+    while (*p != '\0' && *p != ';' && g_token_count < MAX_CORPUS_TOKENS) {
+        const char* start;
+        while (*p == ' ' || *p == '\t' || *p == ',' || *p == '\n' || *p == '\r') {
+            p++;
+        }
+        if (*p == '\0' || *p == ';') {
+            break;
+        }
+        start = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != ',' && *p != '\n' && *p != '\r' && *p != ';') {
+            p++;
+        }
+        g_tokens[g_token_count++] = copy_span(start, (size_t)(p - start));
+        if (*start == '#') {
+            start++;
+        }
+        if ((*start >= '0' && *start <= '9') || *start == '-' || *start == '+') {
+            g_numbers[g_number_count++] = atoi(start);
+        }
+    }
+}
+
+/**
+ * @brief Reads every line of a source file into the corpus
+ */
+static void load_corpus_file(const char* path) {
+    char line[MAX_LINE_LENGTH + 2];
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open corpus file: %s\n", path);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), file) != NULL && g_line_count < MAX_CORPUS_LINES) {
+        g_lines[g_line_count++] = copy_span(line, strlen(line));
+        tokenize_line(line);
+    }
+    fclose(file);
+}
+
+/* --- Benchmark Bodies --- */
+/* Each body runs the primitive once over the whole corpus and returns the bytes consumed. */
+
+static long bench_trim_whitespace(void) {
+    char buffer[MAX_LINE_LENGTH + 2];
+    long bytes = 0;
+    int i;
+    for (i = 0; i < g_line_count; i++) {
+        size_t length = strlen(g_lines[i]);
+        memcpy(buffer, g_lines[i], length + 1);
+        g_sink += *trim_whitespace(buffer);
+        bytes += (long)length;
+    }
+    return bytes;
+}
+
+static long bench_skip_whitespace(void) {
+    long bytes = 0;
+    int i;
+    for (i = 0; i < g_line_count; i++) {
+        char* first = skip_whitespace(g_lines[i]);
+        g_sink += *first;
+        bytes += (long)(first - g_lines[i]) + 1;
+    }
+    return bytes;
+}
+
+static long bench_is_reserved_keyword(void) {
+    long bytes = 0;
+    int i;
+    for (i = 0; i < g_token_count; i++) {
+        g_sink += is_reserved_keyword(g_tokens[i]);
+        bytes += (long)strlen(g_tokens[i]);
+    }
+    return bytes;
+}
+
+static long bench_is_legal_label(void) {
+    long bytes = 0;
+    int i;
+    for (i = 0; i < g_token_count; i++) {
+        g_sink += is_legal_label(g_tokens[i]);
+        bytes += (long)strlen(g_tokens[i]);
+    }
+    return bytes;
+}
+
+static long bench_get_opcode_value(void) {
+    long bytes = 0;
+    int opcode = 0;
+    int i;
+    for (i = 0; i < g_token_count; i++) {
+        g_sink += get_opcode_value(g_tokens[i], &opcode) + opcode;
+        bytes += (long)strlen(g_tokens[i]);
+    }
+    return bytes;
+}
+
+static long bench_get_register_number(void) {
+    long bytes = 0;
+    int i;
+    for (i = 0; i < g_token_count; i++) {
+        g_sink += get_register_number(g_tokens[i]);
+        bytes += (long)strlen(g_tokens[i]);
+    }
+    return bytes;
+}
+
+static long bench_convert_decimal_to_unique_base4(void) {
+    char buffer[BASE4_BUFFER_SIZE];
+    long bytes = 0;
+    int i;
+    for (i = 0; i < g_number_count; i++) {
+        g_sink += *convert_decimal_to_unique_base4(g_numbers[i], buffer);
+        bytes += BASE4_BUFFER_SIZE - 1;
+    }
+    return bytes;
+}
+
+/* --- Runner --- */
+
+/**
+ * @brief Runs a benchmark body repeatedly for at least MIN_BENCH_SECONDS and records the result
+ */
+static void run_benchmark(const char* name, long (*body)(void), int ops_per_round) {
+    clock_t start;
+    double seconds;
+    long rounds = 0;
+    long bytes = 0;
+    BenchResult* result;
+    CounterSample begin_sample;
+    CounterSample end_sample;
+    int i;
+
+    if (ops_per_round == 0 || g_result_count >= MAX_BENCHMARKS) {
+        return;
+    }
+
+    if (g_counters_enabled) {
+        read_hardware_counters(&begin_sample);
+    }
+    start = clock();
+    do {
+        bytes += body();
+        rounds++;
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    } while (seconds < MIN_BENCH_SECONDS);
+    if (g_counters_enabled) {
+        read_hardware_counters(&end_sample);
+    }
+
+    result = &g_results[g_result_count++];
+    strncpy(result->name, name, MAX_BENCH_NAME_LENGTH - 1);
+    result->name[MAX_BENCH_NAME_LENGTH - 1] = '\0';
+    result->ns_per_op = seconds * 1e9 / ((double)rounds * ops_per_round);
+    result->bytes_per_ns = (double)bytes / (seconds * 1e9);
+    result->bytes_per_cycle = 0.0;
+    for (i = 0; i < NUM_HARDWARE_COUNTERS; i++) {
+        result->counters_per_op[i] = 0.0;
+        if (g_counters_enabled) {
+            result->counters_per_op[i] = (double)(end_sample.values[i] - begin_sample.values[i]) /
+                                         ((double)rounds * ops_per_round);
+        }
+    }
+    if (result->counters_per_op[COUNTER_CYCLES] > 0.0) {
+        result->bytes_per_cycle = (double)bytes / (result->counters_per_op[COUNTER_CYCLES] * rounds * ops_per_round);
+    }
+}
+
+/**
+ * @brief Prints the hardware counters of every benchmark, per operation
+ */
+static void print_counter_results(void) {
+    int i;
+    int counter;
+
+    printf("\n%-32s", "benchmark (per op)");
+    for (counter = 0; counter < NUM_HARDWARE_COUNTERS; counter++) {
+        printf(" %13s", hardware_counter_name((HardwareCounter)counter));
+    }
+    printf(" %11s\n", "bytes/cycle");
+
+    for (i = 0; i < g_result_count; i++) {
+        printf("%-32s", g_results[i].name);
+        for (counter = 0; counter < NUM_HARDWARE_COUNTERS; counter++) {
+            if (g_counter_availability.available[counter]) {
+                printf(" %13.2f", g_results[i].counters_per_op[counter]);
+            } else {
+                printf(" %13s", "n/a");
+            }
+        }
+        if (g_results[i].bytes_per_cycle > 0.0) {
+            printf(" %11.3f\n", g_results[i].bytes_per_cycle);
+        } else {
+            printf(" %11s\n", "n/a");
+        }
+    }
+}
+
+/**
+ * @brief Looks up the ns/op of a benchmark in a baseline file
+ * @return The baseline ns/op, or a negative value if the benchmark is not in the file
+ */
+static double find_baseline(const char* baseline_path, const char* name) {
+    char baseline_name[MAX_BENCH_NAME_LENGTH];
+    double ns_per_op;
+    double bytes_per_ns;
+    FILE* file = fopen(baseline_path, "r");
+    if (file == NULL) {
+        return -1.0;
+    }
+    while (fscanf(file, "%63s %lf %lf", baseline_name, &ns_per_op, &bytes_per_ns) == 3) {
+        if (strcmp(baseline_name, name) == 0) {
+            fclose(file);
+            return ns_per_op;
+        }
+    }
+    fclose(file);
+    return -1.0;
+}
+
+int main(int argc, char* argv[]) {
+    const char* save_path = NULL;
+    const char* baseline_path = NULL;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], SAVE_OPTION, strlen(SAVE_OPTION)) == 0) {
+            save_path = argv[i] + strlen(SAVE_OPTION);
+        } else if (strncmp(argv[i], BASELINE_OPTION, strlen(BASELINE_OPTION)) == 0) {
+            baseline_path = argv[i] + strlen(BASELINE_OPTION);
+        } else if (strcmp(argv[i], COUNTERS_OPTION) == 0) {
+            g_counters_enabled = TRUE;
+        } else {
+            load_corpus_file(argv[i]);
+        }
+    }
+
+    if (g_line_count == 0) {
+        printf("Usage: %s [--counters] [--save=<baseline>] [--baseline=<baseline>] <source.as>...\n", argv[0]);
+        return 1;
+    }
+
+    if (g_counters_enabled) {
+        g_counters_enabled = open_hardware_counters();
+        if (!g_counters_enabled) {
+            printf("Hardware performance counters are not available; reporting time only.\n");
+        }
+        read_hardware_counters(&g_counter_availability);
+    }
+
+    printf("Corpus: %d lines, %d tokens, %d numbers\n", g_line_count, g_token_count, g_number_count);
+
+    run_benchmark("trim_whitespace", bench_trim_whitespace, g_line_count);
+    run_benchmark("skip_whitespace", bench_skip_whitespace, g_line_count);
+    run_benchmark("is_reserved_keyword", bench_is_reserved_keyword, g_token_count);
+    run_benchmark("is_legal_label", bench_is_legal_label, g_token_count);
+    run_benchmark("get_opcode_value", bench_get_opcode_value, g_token_count);
+    run_benchmark("get_register_number", bench_get_register_number, g_token_count);
+    run_benchmark("convert_decimal_to_unique_base4", bench_convert_decimal_to_unique_base4, g_number_count);
+
+    printf("%-32s %10s %10s %10s\n", "benchmark", "ns/op", "bytes/ns", "vs base");
+    for (i = 0; i < g_result_count; i++) {
+        double base = (baseline_path != NULL) ? find_baseline(baseline_path, g_results[i].name) : -1.0;
+        printf("%-32s %10.2f %10.3f", g_results[i].name, g_results[i].ns_per_op, g_results[i].bytes_per_ns);
+        if (base > 0.0) {
+            printf(" %+9.1f%%", (g_results[i].ns_per_op - base) * 100.0 / base);
+        }
+        printf("\n");
+    }
+    if (g_counters_enabled) {
+        print_counter_results();
+        close_hardware_counters();
+    }
+
+    if (save_path != NULL) {
+        FILE* file = fopen(save_path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot write baseline file: %s\n", save_path);
+            return 1;
+        }
+        for (i = 0; i < g_result_count; i++) {
+            fprintf(file, "%s %.3f %.4f\n", g_results[i].name, g_results[i].ns_per_op, g_results[i].bytes_per_ns);
+        }
+        fclose(file);
+        printf("Baseline saved to %s\n", save_path);
+    }
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+#!/bin/bash
+#
+# Pathological-input performance checks for the assembler.
+# Each case generates an adversarial source file that stresses a known worst case,
+# runs the assembler on it and fails if the run exceeds its time budget (wall clock,
+# in milliseconds) or its memory budget (virtual memory, in kilobytes, enforced with
+# ulimit), or if its exit status is not the expected one. Budgets are generous
+# multiples of the expected linear-time cost.
+#
+# Fixed budgets only bind when the input is big enough, so every generator also
+# takes a size, and the scaling checks time each case at sizes n and 4n (best of
+# SCALING_RUNS runs). Linear cost gives a ratio near 4, quadratic cost near 16;
+# a ratio above MAX_SCALING_RATIO fails, whatever the speed of the machine.
+#
+# Usage: tests/perf/perf_check.sh <path-to-assembler>
+
+ASSEMBLER="$1"
+if [ -z "$ASSEMBLER" ] || [ ! -x "$ASSEMBLER" ]; then
+    echo "Usage: $0 <path-to-assembler>"
+    exit 2
+fi
+ASSEMBLER="$(cd "$(dirname "$ASSEMBLER")" && pwd)/$(basename "$ASSEMBLER")"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+FAILURES=0
+MAX_SCALING_RATIO=8
+SCALING_RUNS=3
+
+# --- Input Generators ---
+
+# Every generator takes the size of its input as its argument.
+
+# Thousands of macros whose names share a long common prefix, each called once,
+# to stress macro definition and lookup (find_macro).
+generate_shared_prefix_macros() {
+    awk -v n="$1" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "mcro shared_prefix_macro_name_%05d\n inc r1\nmcroend\n", i
+        }
+        for (i = 0; i < n; i++) {
+            printf "shared_prefix_macro_name_%05d\n", i
+        }
+    }'
+}
+
+# Every line exactly MAX_LINE_LENGTH (80) characters long.
+generate_max_length_lines() {
+    awk -v n="$1" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "mov r1, r2 ;%068d\n", i
+        }
+    }'
+}
+
+# A file that is nothing but calls to a handful of macros.
+generate_all_macro_calls() {
+    awk -v n="$1" 'BEGIN {
+        for (m = 0; m < 8; m++) {
+            printf "mcro CallTarget%d\n add r%d, r%d\n prn #-%d\nmcroend\n", m, m, 7 - m, m
+        }
+        for (i = 0; i < n; i++) {
+            printf "CallTarget%d\n", i % 8
+        }
+    }'
+}
+
+# The same names redefined over and over, triggering ERROR_LABEL_REDEFINITION
+# on every repeat (macros are checked by the pre-assembler, labels are repeated
+# for the passes).
+generate_repeated_labels() {
+    awk -v n="$1" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "mcro Repeated%d\n stop\nmcroend\n", i % 10
+            printf "Label%d: inc r%d\n", i % 10, i % 8
+        }
+    }'
+}
+
+# A chain of macros, each calling the previous one, called at a few levels;
+# each macro must be resolved once, not re-expanded at every use, and the
+# depth of the chain must not be limited by the C stack.
+generate_deep_macro_chain() {
+    awk -v n="$1" 'BEGIN {
+        printf "mcro Chain0\n inc r1\nmcroend\n"
+        for (i = 1; i < n; i++) {
+            printf "mcro Chain%d\n Chain%d\n dec r%d\nmcroend\n", i, i - 1, i % 8
+        }
+        for (i = 0; i < n; i += n / 5) {
+            printf "Chain%d\n", i
+        }
+    }'
+}
+
+# Many repeat blocks at the largest count, some calling a macro; each block is
+# classified once and written count times.
+generate_repeat_blocks() {
+    awk -v n="$1" 'BEGIN {
+        printf "mcro Step\n inc r1\n prn r1\nmcroend\n"
+        for (i = 0; i < n; i++) {
+            printf ".rept 256\n mov r%d, r%d\n", i % 8, 7 - i % 8
+            if (i % 2 == 0) {
+                printf " Step\n"
+            }
+            printf ".endr\n"
+        }
+    }'
+}
+
+# Megabyte-scale .data and .string sections.
+generate_large_data_sections() {
+    awk -v n="$1" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "D%d: .data 511, -512, 0, 1, -1, 100, -100, 255, -256, 42, 7\n", i
+            printf "S%d: .string \"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOP\"\n", i
+        }
+    }'
+}
+
+# --- Runner ---
+
+# time_run <base> <time budget ms> <memory budget KB>
+# Runs the assembler once; sets ELAPSED (ms) and STATUS.
+time_run() {
+    local base="$1" time_budget="$2" memory_budget="$3" start end
+
+    start=$(date +%s%N)
+    (ulimit -v "$memory_budget"; timeout $(( time_budget * 5 / 1000 + 1 )) "$ASSEMBLER" "$base" > /dev/null 2>&1)
+    STATUS=$?
+    end=$(date +%s%N)
+    ELAPSED=$(( (end - start) / 1000000 ))
+}
+
+# check_status <name> <expected exit status>
+# Fails the case if the last run was killed or exited with another status.
+check_status() {
+    local name="$1" expected_status="$2"
+
+    if [ $STATUS -ge 124 ]; then
+        echo "FAIL  $name: killed or out of memory (exit $STATUS, ${ELAPSED} ms)"
+    elif [ $STATUS -ne "$expected_status" ]; then
+        echo "FAIL  $name: exit status $STATUS, expected $expected_status"
+    else
+        return 0
+    fi
+    FAILURES=$((FAILURES + 1))
+    return 1
+}
+
+# run_case <name> <generator> <size> <time budget ms> <memory budget KB> <expected exit status>
+run_case() {
+    local name="$1" generator="$2" size="$3" time_budget="$4" memory_budget="$5" expected_status="$6"
+    local base="$WORK_DIR/$name"
+
+    "$generator" "$size" > "$base.as"
+    time_run "$base" "$time_budget" "$memory_budget"
+
+    if ! check_status "$name" "$expected_status"; then
+        return
+    elif [ $ELAPSED -gt "$time_budget" ]; then
+        echo "FAIL  $name: ${ELAPSED} ms exceeds budget of ${time_budget} ms"
+        FAILURES=$((FAILURES + 1))
+    else
+        echo "PASS  $name: ${ELAPSED} ms (budget ${time_budget} ms)"
+    fi
+}
+
+# best_time <name> <base> <expected exit status>
+# Sets BEST to the fastest of SCALING_RUNS runs (ms, at least 1); returns 1 on a bad exit.
+best_time() {
+    local name="$1" base="$2" expected_status="$3" run
+
+    BEST=""
+    for run in $(seq "$SCALING_RUNS"); do
+        time_run "$base" 30000 1048576
+        check_status "$name" "$expected_status" || return 1
+        if [ -z "$BEST" ] || [ $ELAPSED -lt $BEST ]; then
+            BEST=$ELAPSED
+        fi
+    done
+    [ $BEST -ge 1 ] || BEST=1
+}
+
+# run_scaling_case <name> <generator> <size n> <expected exit status>
+# Fails if the time at 4n is more than MAX_SCALING_RATIO times the time at n.
+run_scaling_case() {
+    local name="$1" generator="$2" size="$3" expected_status="$4"
+    local small="$WORK_DIR/${name}_n" large="$WORK_DIR/${name}_4n" small_time ratio
+
+    "$generator" "$size" > "$small.as"
+    "$generator" $(( size * 4 )) > "$large.as"
+    best_time "$name" "$small" "$expected_status" || return
+    small_time=$BEST
+    best_time "$name" "$large" "$expected_status" || return
+
+    ratio=$(awk -v a="$BEST" -v b="$small_time" 'BEGIN { printf "%.1f", a / b }')
+    if awk -v r="$ratio" -v max="$MAX_SCALING_RATIO" 'BEGIN { exit !(r > max) }'; then
+        echo "FAIL  $name scaling: ${small_time} ms at n=$size, ${BEST} ms at 4n (x$ratio, limit x$MAX_SCALING_RATIO)"
+        FAILURES=$((FAILURES + 1))
+    else
+        echo "PASS  $name scaling: ${small_time} ms at n=$size, ${BEST} ms at 4n (x$ratio)"
+    fi
+}
+
+echo "Fixed budgets:"
+run_case shared_prefix_macros generate_shared_prefix_macros 40000  1000 65536  0
+run_case max_length_lines     generate_max_length_lines     100000 1000 65536  0
+run_case all_macro_calls      generate_all_macro_calls      200000 1000 65536  0
+run_case repeated_labels      generate_repeated_labels      20000  1000 65536  1
+run_case deep_macro_chain     generate_deep_macro_chain     200000 3000 262144 0
+run_case repeat_blocks        generate_repeat_blocks        400    1000 65536  0
+run_case large_data_sections  generate_large_data_sections  40000  1000 65536  0
+
+echo "Scaling (n to 4n):"
+run_scaling_case shared_prefix_macros generate_shared_prefix_macros 10000 0
+run_scaling_case max_length_lines     generate_max_length_lines     25000 0
+run_scaling_case all_macro_calls      generate_all_macro_calls      50000 0
+run_scaling_case repeated_labels      generate_repeated_labels      5000  1
+run_scaling_case deep_macro_chain     generate_deep_macro_chain     25000 0
+run_scaling_case repeat_blocks        generate_repeat_blocks        100   0
+run_scaling_case large_data_sections  generate_large_data_sections  10000 0
+
+if [ $FAILURES -ne 0 ]; then
+    echo "$FAILURES performance check(s) failed."
+    exit 1
+fi
+echo "All performance checks passed."
@@ -0,0 +1,97 @@
+#!/bin/bash
+#
+# Parallel-scaling benchmark for the assembler.
+# A corpus of many small source files is assembled at 1, 2, 4 ... N concurrent
+# assembler processes (the way a parallel build runs it), and for every level the
+# throughput (files/s, lines/s), the speedup over one process and the parallel
+# efficiency are reported. The share of system time is reported as well: when
+# efficiency drops while the system share grows, the runs are contending in the
+# kernel (file opens and output writes) rather than in the assembler itself.
+#
+# Usage: tests/perf/scaling.sh <path-to-assembler> [max_jobs] [copies]
+#   max_jobs  Highest level of parallelism (default: number of CPUs)
+#   copies    Number of copies of each corpus file (default: 200)
+
+ASSEMBLER="$1"
+if [ -z "$ASSEMBLER" ] || [ ! -x "$ASSEMBLER" ]; then
+    echo "Usage: $0 <path-to-assembler> [max_jobs] [copies]"
+    exit 2
+fi
+ASSEMBLER="$(cd "$(dirname "$ASSEMBLER")" && pwd)/$(basename "$ASSEMBLER")"
+MAX_JOBS="${2:-$(nproc 2>/dev/null || echo 1)}"
+COPIES="${3:-200}"
+FILES_PER_RUN=16   # Files passed to each assembler process
+
+REPO_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# --- Corpus ---
+
+# A mid-sized generated source, so the corpus is not only tiny files
+generate_mixed_source() {
+    awk 'BEGIN {
+        for (m = 0; m < 20; m++) {
+            printf "mcro Body%d\n add r%d, r%d\n prn #-%d\nmcroend\n", m, m % 8, (7 - m) % 8, m
+        }
+        for (i = 0; i < 2000; i++) {
+            if (i % 4 == 0) {
+                printf "Body%d\n", i % 20
+            } else {
+                printf "L%d: mov r%d, r%d ; line %d\n", i, i % 8, (i + 1) % 8, i
+            }
+        }
+    }'
+}
+
+generate_mixed_source > "$WORK_DIR/mixed.as"
+for i in $(seq 1 "$COPIES"); do
+    cp "$REPO_DIR/tests/valid_macro_example_1.as" "$WORK_DIR/valid_$i.as"
+    cp "$REPO_DIR/test_macro.as" "$WORK_DIR/macro_$i.as"
+    cp "$WORK_DIR/mixed.as" "$WORK_DIR/mixed_$i.as"
+done
+rm -f "$WORK_DIR/mixed.as"
+
+FILE_COUNT=$(ls "$WORK_DIR"/*.as | wc -l)
+LINE_COUNT=$(cat "$WORK_DIR"/*.as | wc -l)
+ls "$WORK_DIR"/*.as | sed 's/\.as$//' > "$WORK_DIR/files.txt"
+
+# --- Runner ---
+
+# run_level <jobs>: prints "<wall ms> <user+sys ms> <sys ms>"
+run_level() {
+    local jobs="$1" start end times
+    rm -f "$WORK_DIR"/*.am
+    start=$(date +%s%N)
+    times=$( { TIMEFORMAT='%U %S'; time xargs -P "$jobs" -n "$FILES_PER_RUN" "$ASSEMBLER" \
+                 < "$WORK_DIR/files.txt" > /dev/null 2>&1; } 2>&1 )
+    end=$(date +%s%N)
+    echo "$(( (end - start) / 1000000 )) $times" |
+        awk '{ printf "%d %d %d\n", $1, ($2 + $3) * 1000, $3 * 1000 }'
+}
+
+echo "Corpus: $FILE_COUNT files, $LINE_COUNT lines ($FILES_PER_RUN files per process)"
+printf "%6s %10s %10s %12s %8s %10s %6s\n" "jobs" "time(ms)" "files/s" "lines/s" "speedup" "efficiency" "sys%"
+
+run_level 1 > /dev/null   # Warm the page cache
+BASE_MS=0
+jobs=1
+while [ "$jobs" -le "$MAX_JOBS" ]; do
+    read -r wall cpu sys <<< "$(run_level "$jobs")"
+    [ "$wall" -lt 1 ] && wall=1
+    [ "$BASE_MS" -eq 0 ] && BASE_MS=$wall
+    awk -v j="$jobs" -v w="$wall" -v c="$cpu" -v s="$sys" -v f="$FILE_COUNT" -v l="$LINE_COUNT" -v b="$BASE_MS" 'BEGIN {
+        speedup = b / w
+        printf "%6d %10d %10.0f %12.0f %8.2f %10.2f %6.1f\n",
+               j, w, f * 1000 / w, l * 1000 / w, speedup, speedup / j, (c > 0) ? 100 * s / c : 0
+        if (j > 1 && speedup / j < 0.7) {
+            printf "       efficiency below 0.70 at %d jobs%s\n", j,
+                   (c > 0 && s / c > 0.3) ? " (mostly system time: file I/O contention)" : ""
+        }
+    }'
+    if [ "$jobs" -eq "$MAX_JOBS" ]; then
+        break
+    fi
+    jobs=$((jobs * 2))
+    [ "$jobs" -gt "$MAX_JOBS" ] && jobs=$MAX_JOBS
+done
@@ -0,0 +1,16 @@
+; Repeat blocks: the lines between .rept N and .endr are written N times
+mcro Twice
+inc r1
+inc r1
+mcroend
+
+MAIN: mov r3, r4
+.rept 3
+prn r3
+Twice
+.endr
+stop
+TABLE: .data 1
+.rept 2
+.data 0, 0
+.endr
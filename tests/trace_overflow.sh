@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+# Checks the --trace output of a run that records more events than the trace
+# ring buffer holds (TRACE_BUFFER_CAPACITY): the trace must start with the
+# "older events dropped" record, and every end event must close a begin event
+# that is in the trace. A missing input records half as many events as a file,
+# so the oldest surviving event falls inside a span.
+#
+# Usage: tests/trace_overflow.sh <path-to-assembler> [file count]
+
+ASSEMBLER="$1"
+FILE_COUNT="${2:-9000}"
+if [ -z "$ASSEMBLER" ] || [ ! -x "$ASSEMBLER" ]; then
+    echo "Usage: $0 <path-to-assembler> [file count]"
+    exit 2
+fi
+ASSEMBLER="$(cd "$(dirname "$ASSEMBLER")" && pwd)/$(basename "$ASSEMBLER")"
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+mkdir "$WORK_DIR/batch"
+
+# Many one-line files
+awk -v n="$FILE_COUNT" -v dir="$WORK_DIR/batch" 'BEGIN {
+    for (i = 0; i < n; i++) {
+        print "stop" > (dir "/file" i ".as")
+        close(dir "/file" i ".as")
+    }
+}'
+
+"$ASSEMBLER" --trace="$WORK_DIR/trace.json" "$WORK_DIR/batch" "$WORK_DIR/missing" > /dev/null 2>&1
+if [ ! -s "$WORK_DIR/trace.json" ]; then
+    echo "FAIL  no trace was written"
+    exit 1
+fi
+
+# One event per line: check the dropped record and the nesting of the phases
+awk '
+    /"ph":"/ {
+        phase = $0
+        sub(/.*"ph":"/, "", phase)
+        phase = substr(phase, 1, 1)
+        events++
+        if (events == 1 && phase != "i") {
+            print "FAIL  the trace does not start with the dropped-events record"
+            failed = 1
+        }
+        if (phase == "B") {
+            depth++
+        } else if (phase == "E") {
+            if (depth == 0) {
+                print "FAIL  end event without a begin at event " events
+                failed = 1
+                exit 1
+            }
+            depth--
+        }
+    }
+    END {
+        if (failed) {
+            exit 1
+        }
+        print "PASS  " events " events, the oldest dropped events are reported, every end has its begin"
+    }
+' "$WORK_DIR/trace.json"
@@ -0,0 +1,170 @@
+#include "trace.h"
+#include "perf_counters.h"
+
+#include <stdio.h>   /* For fopen, fprintf */
+#include <stdlib.h>  /* For malloc, free */
+#include <string.h>  /* For strlen, memcpy */
+
+/* --- Trace Structures --- */
+
+/**
+ * @brief Structure to represent one recorded event
+ */
+typedef struct {
+    const char* name;       /* Name of the span */
+    const char* category;   /* Category of the span */
+    char phase;             /* 'B' for begin, 'E' for end */
+    double timestamp;       /* Seconds since tracing was enabled */
+} TraceEvent;
+
+/**
+ * @brief Structure to represent a copied span name, kept until the trace is written
+ */
+typedef struct TraceName {
+    struct TraceName* next; /* Previously copied name */
+    char text[1];           /* The name, allocated to its full length */
+} TraceName;
+
+/* --- Global Variables for Tracing --- */
+
+static int g_trace_enabled = FALSE;                         /* Whether events are recorded */
+static double g_trace_start = 0.0;                          /* Clock value when tracing was enabled */
+static TraceEvent g_trace_events[TRACE_BUFFER_CAPACITY];    /* Ring buffer of events */
+static unsigned long g_trace_event_count = 0;               /* Number of events ever recorded */
+static TraceName* g_trace_names = NULL;                     /* Names copied by trace_name */
+
+/* --- Internal Helper Functions --- */
+
+/**
+ * @brief Appends an event to the ring buffer, overwriting the oldest one if it is full
+ * @param name The name of the span
+ * @param category The category of the span
+ * @param phase 'B' for begin, 'E' for end
+ */
+static void record_event(const char* name, const char* category, char phase) {
+    TraceEvent* event = &g_trace_events[g_trace_event_count % TRACE_BUFFER_CAPACITY];
+    event->name = name;
+    event->category = category;
+    event->phase = phase;
+    event->timestamp = read_wall_clock_seconds() - g_trace_start;
+    g_trace_event_count++;
+}
+
+/**
+ * @brief Writes a string as a JSON string literal
+ * @param file The output file
+ * @param str The string to write
+ */
+static void write_json_string(FILE* file, const char* str) {
+    fputc('"', file);
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', file);
+            fputc(*str, file);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * @brief Frees the names copied by trace_name
+ */
+static void free_trace_names() {
+    while (g_trace_names != NULL) {
+        TraceName* next = g_trace_names->next;
+        free(g_trace_names);
+        g_trace_names = next;
+    }
+}
+
+/* --- Public Functions Implementation --- */
+
+void enable_trace() {
+    g_trace_enabled = TRUE;
+    g_trace_event_count = 0;
+    g_trace_start = read_wall_clock_seconds();
+}
+
+const char* trace_name(const char* name) {
+    TraceName* copy;
+    size_t length;
+
+    if (!g_trace_enabled) {
+        return name;
+    }
+    length = strlen(name);
+    copy = malloc(sizeof(TraceName) + length);
+    if (copy == NULL) {
+        return "(name unavailable)";
+    }
+    memcpy(copy->text, name, length + 1);
+    copy->next = g_trace_names;
+    g_trace_names = copy;
+    return copy->text;
+}
+
+void trace_begin(const char* name, const char* category) {
+    if (g_trace_enabled) {
+        record_event(name, category, 'B');
+    }
+}
+
+void trace_end(const char* name, const char* category) {
+    if (g_trace_enabled) {
+        record_event(name, category, 'E');
+    }
+}
+
+int write_trace(const char* trace_path) {
+    FILE* trace_file;
+    unsigned long first;
+    unsigned long written = 0;
+    unsigned long depth = 0;    /* Spans open at the current event */
+    unsigned long i;
+
+    trace_file = fopen(trace_path, "w");
+    if (trace_file == NULL) {
+        free_trace_names();
+        return FALSE;
+    }
+
+    /* Only the most recent TRACE_BUFFER_CAPACITY events survive in the ring buffer */
+    first = (g_trace_event_count > TRACE_BUFFER_CAPACITY) ? g_trace_event_count - TRACE_BUFFER_CAPACITY : 0;
+
+    fprintf(trace_file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    if (first > 0) {
+        /* An instant event marks where the surviving events start */
+        fprintf(trace_file, "{\"name\":\"trace buffer full: %lu older events dropped\",\"cat\":\"trace\","
+                "\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":1}",
+                first, g_trace_events[first % TRACE_BUFFER_CAPACITY].timestamp * 1e6);
+        written++;
+    }
+    for (i = first; i < g_trace_event_count; i++) {
+        TraceEvent* event = &g_trace_events[i % TRACE_BUFFER_CAPACITY];
+        
+        /* Spans are strictly nested, so an end with no open span lost its begin */
+        if (event->phase == 'E') {
+            if (depth == 0) {
+                continue;
+            }
+            depth--;
+        } else {
+            depth++;
+        }
+        fprintf(trace_file, "%s{\"name\":", (written++ == 0) ? "" : ",\n");
+        write_json_string(trace_file, event->name);
+        fprintf(trace_file, ",\"cat\":");
+        write_json_string(trace_file, event->category);
+        fprintf(trace_file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":1}",
+                event->phase, event->timestamp * 1e6);
+    }
+    fprintf(trace_file, "\n]}\n");
+
+    g_trace_enabled = FALSE;
+    free_trace_names();
+    return fclose(trace_file) == 0;
+}
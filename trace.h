@@ -0,0 +1,58 @@
+#ifndef ASSEMBLER_TRACE_H
+#define ASSEMBLER_TRACE_H
+
+/* Include necessary project definitions */
+#include "definitions.h" /* Includes TRUE/FALSE */
+
+/**
+ * @brief This header file declares the timeline trace of the --trace mode.
+ * Begin/end events for every processed file and every stage are recorded into a
+ * fixed-size ring buffer (the oldest events are overwritten when it is full, so
+ * recording never allocates) and written at the end of the run in the Chrome
+ * trace-event JSON format, which timeline viewers such as chrome://tracing and
+ * Perfetto can open. If events were overwritten, the trace starts with an instant
+ * event counting them, and ends whose begin was overwritten are left out.
+ * When tracing is disabled, recording costs a single flag test.
+ */
+
+/**
+ * @brief Number of events the trace ring buffer holds.
+ */
+#define TRACE_BUFFER_CAPACITY 65536
+
+/* --- Trace Functions --- */
+
+/**
+ * @brief Enables trace recording for the rest of the run.
+ */
+void enable_trace();
+
+/**
+ * @brief Copies a span name that does not outlive the span, e.g. a bundle member name.
+ * @param name The name to copy.
+ * @return A copy valid until the trace is written (name itself when tracing is disabled).
+ */
+const char* trace_name(const char* name);
+
+/**
+ * @brief Records the beginning of a span.
+ * @param name The name of the span (must stay valid until the trace is written).
+ * @param category The category of the span, e.g. "file" or "stage" (must stay valid as well).
+ */
+void trace_begin(const char* name, const char* category);
+
+/**
+ * @brief Records the end of the most recent span with the same name.
+ * @param name The name of the span.
+ * @param category The category of the span.
+ */
+void trace_end(const char* name, const char* category);
+
+/**
+ * @brief Writes the recorded events as Chrome trace-event JSON.
+ * @param trace_path The path of the JSON file to write.
+ * @return TRUE if the file was written, FALSE otherwise.
+ */
+int write_trace(const char* trace_path);
+
+#endif /* ASSEMBLER_TRACE_H */
@@ -13,6 +13,51 @@ static const char* opcode_names[] = {
     "dec", "jmp", "bne", "red", "prn", "jsr", "rts", "stop"
 };
 
+/*
+ * Instruction specification: operand count and the sets of legal source and
+ * destination addressing methods for every opcode (in Opcode enum order).
+ * The operand count and legality tables below are expanded from this list at
+ * compile time, so the specification is written down exactly once.
+ */
+#define INSTRUCTION_SPEC(X) \
+    X(2, ADDRESSING_SET_ALL,              ADDRESSING_SET_NO_IMMEDIATE)     /* mov */ \
+    X(2, ADDRESSING_SET_ALL,              ADDRESSING_SET_ALL)              /* cmp */ \
+    X(2, ADDRESSING_SET_ALL,              ADDRESSING_SET_NO_IMMEDIATE)     /* add */ \
+    X(2, ADDRESSING_SET_ALL,              ADDRESSING_SET_NO_IMMEDIATE)     /* sub */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_NO_IMMEDIATE)     /* not */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_NO_IMMEDIATE)     /* clr */ \
+    X(2, ADDRESSING_SET_DIRECT_OR_MATRIX, ADDRESSING_SET_NO_IMMEDIATE)     /* lea */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_NO_IMMEDIATE)     /* inc */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_NO_IMMEDIATE)     /* dec */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_DIRECT_OR_MATRIX) /* jmp */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_DIRECT_OR_MATRIX) /* bne */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_NO_IMMEDIATE)     /* red */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_ALL)              /* prn */ \
+    X(1, ADDRESSING_SET_NONE,             ADDRESSING_SET_DIRECT_OR_MATRIX) /* jsr */ \
+    X(0, ADDRESSING_SET_NONE,             ADDRESSING_SET_NONE)             /* rts */ \
+    X(0, ADDRESSING_SET_NONE,             ADDRESSING_SET_NONE)             /* stop */
+
+#define SPEC_OPERAND_COUNT(count, src_set, dst_set) count,
+#define SPEC_ADDRESSING_BITS(count, src_set, dst_set) ADDRESSING_PAIR_BITS(src_set, dst_set),
+
+/* Number of operands required by each opcode */
+static const unsigned char operand_counts[NUM_OPCODES] = {
+    INSTRUCTION_SPEC(SPEC_OPERAND_COUNT)
+};
+
+/* Number of information words added by an operand, indexed by AddressingMethod */
+static const unsigned char operand_word_counts[NUM_ADDRESSING_METHODS] = {
+    1, /* ADDRESSING_IMMEDIATE: the value */
+    1, /* ADDRESSING_DIRECT: the address */
+    2, /* ADDRESSING_MATRIX: the address, then both index registers */
+    1  /* ADDRESSING_REGISTER_DIRECT: the register number */
+};
+
+/* 4x4 legality bitset for each opcode: bit (source * 4 + destination) */
+static const unsigned short addressing_table[NUM_OPCODES] = {
+    INSTRUCTION_SPEC(SPEC_ADDRESSING_BITS)
+};
+
 /* Array of all reserved directive names */
 static const char* directive_names[] = {
     ".data", ".string", ".mat", ".entry", ".extern"
@@ -189,45 +234,72 @@ int is_reserved_keyword(const char* str) {
 }
 
 /**
- * @brief Checks if a given string is a legal label (symbol) according to the assembly language rules.
- * A legal label must:
- * - Start with an alphabetic character [7, 12, 14].
- * - Be followed by zero or more alphanumeric characters or underscores [7, 12, 14].
- * - Have a maximum length defined by MAX_LABEL_LENGTH (30 characters) [7, 12, 14].
- * - Not be a reserved keyword (e.g., an opcode, a directive name, or a register name) [7, 14, 15].
- * @param label The string to validate as a label.
- * @return TRUE if the label is legal, FALSE otherwise.
+ * @brief Classifies an identifier in a single scan of its characters.
+ * The name is first checked for well-formedness (a letter followed by letters, digits
+ * or underscores, or a '.'-prefixed directive name), and only then looked up in the
+ * opcode, directive and register tables.
+ * @param name The identifier to classify.
+ * @return The IdentifierClass of the name.
  */
-int is_legal_label(const char* label) {
-    int i;
-    
-    if (label == NULL || *label == '\0') {
-        return FALSE; /* Label cannot be empty */
+IdentifierClass classify_identifier(const char* name) {
+    unsigned int i;
+    int length;
+
+    if (name == NULL || *name == '\0') {
+        return IDENTIFIER_EMPTY;
     }
 
-    /* Rule 1: Must start with an alphabetic character */
-    if (!is_alpha(*label)) {
-        return FALSE;
+    /* Directive names are the only keywords that do not start with a letter */
+    if (*name == '.') {
+        for (i = 0; i < sizeof(directive_names) / sizeof(directive_names[0]); i++) {
+            if (strcmp(name, directive_names[i]) == 0) {
+                return IDENTIFIER_DIRECTIVE;
+            }
+        }
+        return IDENTIFIER_BAD_CHARS;
     }
 
-    /* Rule 2: Followed by zero or more alphanumeric characters */
-    for (i = 1; label[i] != '\0'; i++) {
-        if (!is_alphanumeric(label[i])) {
-            return FALSE;
+    /* Must start with a letter, followed by alphanumeric characters */
+    if (!is_alpha(*name)) {
+        return IDENTIFIER_BAD_CHARS;
+    }
+    for (length = 1; name[length] != '\0'; length++) {
+        if (!is_alphanumeric(name[length])) {
+            return IDENTIFIER_BAD_CHARS;
         }
     }
 
-    /* Rule 3: Maximum length defined by MAX_LABEL_LENGTH */
-    if (strlen(label) > MAX_LABEL_LENGTH) {
-        return FALSE;
+    if (length > MAX_LABEL_LENGTH) {
+        return IDENTIFIER_TOO_LONG;
     }
 
-    /* Rule 4: Not a reserved keyword */
-    if (is_reserved_keyword(label)) {
-        return FALSE;
+    /* Keywords: registers are exactly 2 characters, opcodes 3 or 4 */
+    if (get_register_number(name) >= 0) {
+        return IDENTIFIER_REGISTER;
+    }
+    if (length <= 4) {
+        for (i = 0; i < sizeof(opcode_names) / sizeof(opcode_names[0]); i++) {
+            if (strcmp(name, opcode_names[i]) == 0) {
+                return IDENTIFIER_OPCODE;
+            }
+        }
     }
 
-    return TRUE;
+    return IDENTIFIER_LEGAL;
+}
+
+/**
+ * @brief Checks if a given string is a legal label (symbol) according to the assembly language rules.
+ * A legal label must:
+ * - Start with an alphabetic character [7, 12, 14].
+ * - Be followed by zero or more alphanumeric characters or underscores [7, 12, 14].
+ * - Have a maximum length defined by MAX_LABEL_LENGTH (30 characters) [7, 12, 14].
+ * - Not be a reserved keyword (e.g., an opcode, a directive name, or a register name) [7, 14, 15].
+ * @param label The string to validate as a label.
+ * @return TRUE if the label is legal, FALSE otherwise.
+ */
+int is_legal_label(const char* label) {
+    return classify_identifier(label) == IDENTIFIER_LEGAL;
 }
 
 /* --- Base Conversion Functions --- */
@@ -314,4 +386,60 @@ int get_register_number(const char* str) {
     }
 
     return -1; /* Not a valid register number */
-}
\ No newline at end of file
+}
+
+/* --- Instruction Specification Lookup Functions --- */
+
+/**
+ * @brief Returns the number of operands required by an opcode.
+ * @param opcode The opcode value (0-15), as defined by the Opcode enum.
+ * @return The required operand count (0, 1 or 2), or -1 if the opcode is out of range.
+ */
+int get_operand_count(int opcode) {
+    if (opcode < 0 || opcode >= NUM_OPCODES) {
+        return -1;
+    }
+    return operand_counts[opcode];
+}
+
+/**
+ * @brief Checks whether a pair of addressing methods is legal for an opcode.
+ * This is a single bit test in the compile-time legality table. The source method
+ * is ignored for one-operand instructions; the operand count must be checked
+ * separately with get_operand_count.
+ * @param opcode The opcode value (0-15), as defined by the Opcode enum.
+ * @param source_method The addressing method of the source operand (0-3).
+ * @param destination_method The addressing method of the destination operand (0-3).
+ * @return TRUE if the combination is legal, FALSE otherwise.
+ */
+int is_legal_addressing(int opcode, int source_method, int destination_method) {
+    if (opcode < 0 || opcode >= NUM_OPCODES ||
+        source_method < 0 || source_method >= NUM_ADDRESSING_METHODS ||
+        destination_method < 0 || destination_method >= NUM_ADDRESSING_METHODS) {
+        return FALSE;
+    }
+    return (addressing_table[opcode] >> (source_method * NUM_ADDRESSING_METHODS + destination_method)) & 1;
+}
+
+/**
+ * @brief Returns the number of machine words an instruction occupies.
+ * @param operand_count The number of operands of the instruction (0-2).
+ * @param source_method The addressing method of the source operand (ignored unless there are 2 operands).
+ * @param destination_method The addressing method of the destination operand (ignored if there are none).
+ * @return The total number of words (1-5).
+ */
+int get_instruction_word_count(int operand_count, int source_method, int destination_method) {
+    int word_count = 1; /* The first word */
+
+    if (operand_count >= 1 && destination_method >= 0 && destination_method < NUM_ADDRESSING_METHODS) {
+        word_count += operand_word_counts[destination_method];
+    }
+    if (operand_count == 2 && source_method >= 0 && source_method < NUM_ADDRESSING_METHODS) {
+        /* Two register operands are encoded together in one shared word */
+        if (source_method == ADDRESSING_REGISTER_DIRECT && destination_method == ADDRESSING_REGISTER_DIRECT) {
+            return word_count;
+        }
+        word_count += operand_word_counts[source_method];
+    }
+    return word_count;
+}
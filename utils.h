@@ -77,6 +77,29 @@ int is_comment_line(const char* line);
 
 /** --- Label and Keyword Validation Functions --- **/
 
+/**
+ * @brief Classification of an identifier (label, macro name or operand symbol).
+ * Computed once per distinct name by classify_identifier, so callers can pick the
+ * matching error without re-running the keyword and character checks.
+ */
+typedef enum {
+    IDENTIFIER_LEGAL = 0,       /* A legal label or macro name */
+    IDENTIFIER_OPCODE,          /* An operation name (mov, add, ..., stop) */
+    IDENTIFIER_DIRECTIVE,       /* A directive name (.data, .string, .mat, .entry, .extern) */
+    IDENTIFIER_REGISTER,        /* A register name (r0-r7) */
+    IDENTIFIER_EMPTY,           /* An empty string */
+    IDENTIFIER_TOO_LONG,        /* Well-formed, but longer than MAX_LABEL_LENGTH */
+    IDENTIFIER_BAD_CHARS        /* Does not start with a letter or contains illegal characters */
+} IdentifierClass;
+
+/**
+ * @brief Classifies an identifier in a single scan of its characters.
+ * The keyword tables are consulted only when the name is well-formed.
+ * @param name The identifier to classify.
+ * @return The IdentifierClass of the name.
+ */
+IdentifierClass classify_identifier(const char* name);
+
 /**
  * @brief Checks if a given string is a legal label (symbol) according to the assembly language rules.
  * A legal label must:
@@ -133,4 +156,37 @@ int get_opcode_value(const char* op_name, int* opcode_val);
  */
 int get_register_number(const char* str);
 
+/* --- Instruction Specification Lookup Functions --- */
+
+/**
+ * @brief Returns the number of operands required by an opcode.
+ * @param opcode The opcode value (0-15), as defined by the Opcode enum.
+ * @return The required operand count (0, 1 or 2), or -1 if the opcode is out of range.
+ */
+int get_operand_count(int opcode);
+
+/**
+ * @brief Checks whether a pair of addressing methods is legal for an opcode.
+ * The check is a single bit test in a legality table generated at compile time
+ * from the instruction specification. For one-operand instructions the source
+ * method is ignored; use get_operand_count to validate the number of operands.
+ * @param opcode The opcode value (0-15), as defined by the Opcode enum.
+ * @param source_method The addressing method of the source operand (0-3).
+ * @param destination_method The addressing method of the destination operand (0-3).
+ * @return TRUE if the combination is legal, FALSE otherwise.
+ */
+int is_legal_addressing(int opcode, int source_method, int destination_method);
+
+/**
+ * @brief Returns the number of machine words an instruction occupies.
+ * Every instruction has a first word; each operand adds its information words
+ * (one for immediate, direct and register operands, two for matrix operands),
+ * except that two register operands share a single word.
+ * @param operand_count The number of operands of the instruction (0-2).
+ * @param source_method The addressing method of the source operand (ignored unless there are 2 operands).
+ * @param destination_method The addressing method of the destination operand (ignored if there are none).
+ * @return The total number of words (1-5).
+ */
+int get_instruction_word_count(int operand_count, int source_method, int destination_method);
+
 #endif /* ASSEMBLER_UTILS_H */ 
\ No newline at end of file